@@ -0,0 +1,187 @@
+// bin2tab.cpp:
+// Copyright (C) 2026 Giorgio Biagetti and Simone Orcioni
+/*
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+	A reader of the binary trace files written by create_bin_trace_file,
+	printing them in the text format of the tab trace files: the names of
+	the columns and the comments as lines starting with '#', then one row
+	of tab separated values per sample. It does not need SystemC, and it
+	finds the blocks through the index at the end of the file, as any
+	reader wanting to seek to a given time would do (see src/tab_trace.cpp
+	for the layout).
+*/
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// the column types of bin_trace_file::type:
+enum type {t_bool = 1, t_int8, t_uint8, t_int16, t_uint16, t_int32, t_uint32, t_int64, t_uint64, t_float, t_double, t_logic, t_enum};
+
+struct column
+{
+	uint8_t type;
+	uint32_t size;
+	int32_t width;
+	std::string name;
+	std::vector <std::string> literals;
+};
+
+struct block_entry {uint64_t offset; uint32_t rows; double first, last;};
+
+struct remark {double time; std::string text;};
+
+static FILE *in;
+
+static bool get (void *data, size_t size)
+{
+	return fread(data, 1, size, in) == size;
+}
+
+static bool get_string (std::string &text)
+{
+	uint32_t length;
+	if (!get(&length, sizeof length)) return false;
+	text.resize(length);
+	return !length || get(&text[0], length);
+}
+
+template <class T> static T value (unsigned char const *p)
+{
+	T x;
+	memcpy(&x, p, sizeof x);
+	return x;
+}
+
+static std::string format (column const &c, unsigned char const *p)
+{
+	char number[32];
+	switch (c.type) {
+	case t_bool    : return value<uint8_t>(p) ? "1" : "0";
+	case t_int8    : snprintf(number, sizeof number, "%d", value<int8_t>(p)); break;
+	case t_uint8   : snprintf(number, sizeof number, "%u", value<uint8_t>(p)); break;
+	case t_int16   : snprintf(number, sizeof number, "%d", value<int16_t>(p)); break;
+	case t_uint16  : snprintf(number, sizeof number, "%u", value<uint16_t>(p)); break;
+	case t_int32   : snprintf(number, sizeof number, "%d", value<int32_t>(p)); break;
+	case t_uint32  : snprintf(number, sizeof number, "%u", value<uint32_t>(p)); break;
+	case t_int64   : snprintf(number, sizeof number, "%lld", (long long) value<int64_t>(p)); break;
+	case t_uint64  : snprintf(number, sizeof number, "%llu", (unsigned long long) value<uint64_t>(p)); break;
+	case t_float   : snprintf(number, sizeof number, "%e", value<float>(p)); break;
+	case t_double  : snprintf(number, sizeof number, "%e", value<double>(p)); break;
+	case t_logic   : return std::string((char const *) p, c.size);
+	case t_enum    : {
+		const uint32_t k = value<uint32_t>(p);
+		if (k < c.literals.size()) return c.literals[k];
+		snprintf(number, sizeof number, "%u", k);
+		break;
+	}
+	default        : return "?";
+	}
+	return number;
+}
+
+static int fail (char const *message)
+{
+	fprintf(stderr, "bin2tab: %s.\n", message);
+	return 1;
+}
+
+int main (int argc, char *argv[])
+{
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s <trace.bin>\n", argv[0]);
+		return 1;
+	}
+	if (!(in = fopen(argv[1], "rb"))) return fail("cannot open the trace file");
+
+	// header:
+	char magic[8];
+	uint32_t bom, version, count;
+	if (!get(magic, sizeof magic) || memcmp(magic, "WMSTRACE", 8)) return fail("not a binary trace file");
+	if (!get(&bom, sizeof bom) || !get(&version, sizeof version) || !get(&count, sizeof count)) return fail("truncated header");
+	if (bom != 0x01020304) return fail("trace file written with a different byte order");
+	if (version != 1) return fail("unknown version of the trace file");
+	std::vector <column> columns(count);
+	for (unsigned i = 0; i < count; ++i) {
+		column &c = columns[i];
+		uint32_t literals;
+		if (!get(&c.type, sizeof c.type) || !get(&c.size, sizeof c.size) || !get(&c.width, sizeof c.width) || !get_string(c.name) || !get(&literals, sizeof literals))
+			return fail("truncated header");
+		c.literals.resize(literals);
+		for (unsigned k = 0; k < literals; ++k)
+			if (!get_string(c.literals[k])) return fail("truncated header");
+	}
+	if (!count || columns[0].type != t_double) return fail("missing time column");
+
+	// footer, found from the end of the file:
+	uint64_t footer;
+	uint32_t blocks, remarks;
+	if (fseek(in, -8 - int(sizeof footer) - int(sizeof blocks), SEEK_END) || !get(&blocks, sizeof blocks) || !get(&footer, sizeof footer) || !get(magic, sizeof magic) || memcmp(magic, "WMSINDEX", 8))
+		return fail("missing index, the trace file was not closed");
+	if (fseek(in, long(footer), SEEK_SET)) return fail("bad index");
+	std::vector <block_entry> index(blocks);
+	for (unsigned i = 0; i < blocks; ++i) {
+		block_entry &b = index[i];
+		if (!get(&b.offset, sizeof b.offset) || !get(&b.rows, sizeof b.rows) || !get(&b.first, sizeof b.first) || !get(&b.last, sizeof b.last))
+			return fail("bad index");
+	}
+	if (!get(&remarks, sizeof remarks)) return fail("bad index");
+	std::vector <remark> comments(remarks);
+	for (unsigned i = 0; i < remarks; ++i)
+		if (!get(&comments[i].time, sizeof comments[i].time) || !get_string(comments[i].text)) return fail("bad index");
+
+	// the names, as the tab files give them:
+	for (unsigned i = 1; i < count; ++i)
+		printf("# % 3d: %s\n", i + 1, columns[i].name.c_str());
+
+	// blocks, with every comment before the first row traced after it:
+	unsigned next = 0;
+	std::vector <unsigned char> data;
+	for (unsigned i = 0; i < blocks; ++i) {
+		uint32_t rows;
+		if (fseek(in, long(index[i].offset), SEEK_SET) || !get(&rows, sizeof rows) || rows != index[i].rows) return fail("bad block");
+		std::vector <unsigned char const *> arrays(count);
+		size_t size = 0;
+		for (unsigned k = 0; k < count; ++k) size += rows * columns[k].size;
+		data.resize(size);
+		if (!get(data.data(), size)) return fail("truncated block");
+		size = 0;
+		for (unsigned k = 0; k < count; ++k) {
+			arrays[k] = data.data() + size;
+			size += rows * columns[k].size;
+		}
+		for (uint32_t r = 0; r < rows; ++r) {
+			const double t = value<double>(arrays[0] + r * sizeof (double));
+			for (; next < remarks && comments[next].time <= t; ++next)
+				printf("# %s\n", comments[next].text.c_str());
+			std::string line;
+			for (unsigned k = 0; k < count; ++k) {
+				if (k) line += '\t';
+				line += format(columns[k], arrays[k] + r * columns[k].size);
+			}
+			puts(line.c_str());
+		}
+	}
+	for (; next < remarks; ++next)
+		printf("# %s\n", comments[next].text.c_str());
+
+	fclose(in);
+	return 0;
+}
@@ -0,0 +1,65 @@
+// rc.cpp:
+// Copyright (C) 2026 Giorgio Biagetti and Simone Orcioni
+/*
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+	An RC load on the mains, traced to the binary file TRACES.bin, with
+	a comment marking the half of the run. The file can be converted to
+	the text format of the tab traces with the bin2tab reader:
+	./test && ./bin2tab TRACES.bin > TRACES.txt
+*/
+
+#include "wave_system"
+
+#include "sys/sources"
+#include "devices/electrical_oneport.h"
+
+#include "nature/electrical"
+#include "units/electrical"
+#include "units/constants"
+
+#include "tab_trace"
+
+
+// main program:
+int sc_main (int argc, char *argv[])
+{
+	sc_core::sc_signal <double> angle;
+	ab_signal <electrical, parallel> mains(10 ohm);
+
+	// small blocks, so that the run spans several of them:
+	sc_core::sc_trace_file *f = create_bin_trace_file("TRACES", 0, 256);
+	mains.trace(f, "MAINS");
+	sc_core::sc_trace(f, angle, "SOURCE");
+
+	generator <double> signal_source("SOURCE1", sine(sqrt(2) * 230, 50 Hz, 0));
+	signal_source(angle);
+
+	source <electrical> wave_source("GENERATOR", cfg::across);
+	wave_source.input(angle);
+	wave_source.port(mains);
+
+	RCs_load load("LOAD", 100 ohm, 10e-6);
+	load(mains);
+
+	sc_core::sc_start(sc_core::sc_time(0.05, sc_core::SC_SEC));
+	f->write_comment("half of the run");
+	sc_core::sc_start(sc_core::sc_time(0.05, sc_core::SC_SEC));
+
+	close_bin_trace_file(f);
+	return 0;
+}
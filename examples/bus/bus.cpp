@@ -0,0 +1,100 @@
+// bus.cpp:
+// Copyright (C) 2026 Giorgio Biagetti and Simone Orcioni
+/*
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+	Three single conductor sources are gathered on a multiconductor bus,
+	which feeds, through a line with mutual resistances, three magnetically
+	coupled windings and a resistive load matrix in parallel.
+*/
+
+#include <systemc.h>
+#include <array>
+
+#include "wave_system"
+
+#include "sys/sources"
+#include "sys/multiconductor"
+
+#include "nature/electrical"
+#include "units/electrical"
+#include "units/constants"
+
+#include "tab_trace"
+
+
+// main program:
+int sc_main (int argc, char *argv[])
+{
+	const double pi = 3.1415926535897932384626433832795;
+
+	// Line: 0.5 ohm per conductor, 0.1 ohm of mutual resistance:
+	const conductor_matrix<3> R_line(std::array <std::array <double, 3>, 3> {{
+		{{0.5, 0.1, 0.1}},
+		{{0.1, 0.5, 0.1}},
+		{{0.1, 0.1, 0.5}}
+	}});
+	// Windings: 10 mH self inductance with a coupling factor of 0.5:
+	const conductor_matrix<3> L_load(std::array <std::array <double, 3>, 3> {{
+		{{10e-3, 5e-3, 5e-3}},
+		{{5e-3, 10e-3, 5e-3}},
+		{{5e-3, 5e-3, 10e-3}}
+	}});
+
+	sc_core::sc_signal <double> angle[3];
+	ab_signal <electrical, parallel> wire[3];
+	ab_signal <multiconductor<3>, parallel> supply(10 ohm), load(10 ohm);
+
+	sc_core::sc_trace_file *f = create_tab_trace_file("TRACES");
+	supply.trace(f, "SUPPLY");
+	load.trace(f, "LOAD");
+
+	generator <double> signal_source0("SOURCE0", sine(sqrt(2) * 230, 50 Hz, 0));
+	generator <double> signal_source1("SOURCE1", sine(sqrt(2) * 230, 50 Hz, -2 * pi / 3));
+	generator <double> signal_source2("SOURCE2", sine(sqrt(2) * 230, 50 Hz, +2 * pi / 3));
+	signal_source0(angle[0]);
+	signal_source1(angle[1]);
+	signal_source2(angle[2]);
+
+	source <electrical> wave_source0("GENERATOR0", cfg::across);
+	source <electrical> wave_source1("GENERATOR1", cfg::across);
+	source <electrical> wave_source2("GENERATOR2", cfg::across);
+	wave_source0.input(angle[0]);
+	wave_source1.input(angle[1]);
+	wave_source2.input(angle[2]);
+	wave_source0.port(wire[0]);
+	wave_source1.port(wire[1]);
+	wave_source2.port(wire[2]);
+
+	bus2wires<3> gather("GATHER");
+	gather.bus(supply);
+	for (int k = 0; k < 3; ++k) gather.wire[k](wire[k]);
+
+	Rs_2s_bus<3> line("LINE", R_line);
+	line(supply, load);
+
+	RLs_load_bus<3> windings("WINDINGS", conductor_matrix<3>(2 ohm), L_load);
+	windings(load);
+
+	R_load_bus<3> resistors("RESISTORS", conductor_matrix<3>(100 ohm));
+	resistors(load);
+
+	sc_core::sc_start(sc_core::sc_time(0.2, sc_core::SC_SEC));
+
+	close_tab_trace_file(f);
+	return 0;
+}
@@ -0,0 +1,108 @@
+// rc.cpp:
+// Copyright (C) 2026 Giorgio Biagetti and Simone Orcioni
+/*
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+	A Monte Carlo analysis in a single run: a sine current source drives
+	a parallel RC load whose resistance and capacitance are drawn with
+	their tolerances, eight samples at a time on the lanes of an ensemble
+	nature. The traces have a column per sample, numbered in brackets.
+*/
+
+#include <systemc.h>
+#include <iostream>
+#include <random>
+
+#include "wave_system"
+
+#include "sys/sources"
+#include "sys/ensemble"
+
+#include "nature/electrical"
+#include "units/electrical"
+#include "units/constants"
+
+#include "tab_trace"
+
+const int samples = 8;
+typedef ensemble <electrical, samples> electrical_mc;
+typedef electrical_mc::wave_type sample_type;
+
+// the same sine on all the lanes:
+struct sine_mc : function_base <sample_type>
+{	CLONABLE
+	sine_mc (double amplitude, double frequency) : waveform(amplitude, frequency) {}
+	sample_type operator () (double &t) const {return sample_type(waveform(t));}
+private:
+	sine waveform;
+};
+
+// main program:
+int sc_main (int argc, char *argv[])
+{
+	// Command-line parameters:
+	double sim_time;
+	double tolerance;
+
+	if (argc == 3) {
+		sscanf(argv[1], "%lf", &sim_time);
+		sscanf(argv[2], "%lf", &tolerance);
+	} else {
+		std::cout << "Usage: " << argv[0] << " <sim_time> <tolerance>\n\n";
+		std::cout << "sim_time  -> duration of simulation [s];\n";
+		std::cout << "tolerance -> relative standard deviation of R and C, e.g., 0.05.\n";
+		std::cout << std::endl;
+		return 1;
+	}
+
+	// Mersenne-twister random number generator:
+	std::mt19937_64 engine;
+	engine.seed(std::mt19937_64::default_seed);
+	std::normal_distribution <double> spread(1.0, tolerance);
+
+	sample_type R, C;
+	for (int k = 0; k < samples; ++k) {
+		R[k] = 100 ohm * spread(engine);
+		C[k] = 10e-6 * spread(engine);
+	}
+
+	sc_core::sc_set_time_resolution(1.0, sc_core::SC_NS);
+
+	sc_core::sc_signal <sample_type> current;
+	ab_signal <electrical_mc, parallel> load(100 ohm);
+
+	sc_core::sc_trace_file *f = create_tab_trace_file("TRACES");
+	load.trace(f, "LOAD");
+
+	generator <sample_type> signal_source("SOURCE1", sine_mc(1, 50 Hz));
+	signal_source(current);
+
+	source <electrical_mc> wave_source("GENERATOR", cfg::through);
+	wave_source.input(current);
+	wave_source.port(load);
+
+	P_load_mc <electrical_mc> resistor("R", R);
+	resistor(load);
+
+	I_load_mc <electrical_mc> capacitor("C", C);
+	capacitor(load);
+
+	sc_core::sc_start(sc_core::sc_time(sim_time, sc_core::SC_SEC));
+
+	close_tab_trace_file(f);
+	return 0;
+}
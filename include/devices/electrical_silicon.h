@@ -61,23 +61,34 @@ struct mosfet
 {
 	mosfet (double Vsat, double Isat, int n);
 	double current (double a, bool gate) const;
+	double conductance (double a, bool gate) const;
 	const double R, alpha, beta, gamma;
 };
 
-struct mosfet_1p : mosfet, wave_module <1, electrical>
+struct mosfet_1p : mosfet, wave_module <1, electrical>, nonlinear_element
 {       
 	SC_HAS_PROCESS(mosfet_1p);
 	mosfet_1p (sc_core::sc_module_name name, double Vsat, double Isat);
 	sc_core::sc_in <bool> control;
+	// nonlinear element description:
+	unsigned scattering_ports () const {return 1;}
+	const sc_core::sc_port_base *scattering_port (unsigned k) const {return &port;}
+	void reflection (double const *a, double *b) const;
+	void derivatives (double const *a, double *jacobian) const;
 private:
 	void calculus ();
 };
 
-struct mosfet_2p : mosfet, wave_module <2, electrical>
+struct mosfet_2p : mosfet, wave_module <2, electrical>, nonlinear_element
 {       
 	SC_HAS_PROCESS(mosfet_2p);
 	mosfet_2p (sc_core::sc_module_name name, double Vsat, double Isat);
 	sc_core::sc_in <bool> control;
+	// nonlinear element description:
+	unsigned scattering_ports () const {return 2;}
+	const sc_core::sc_port_base *scattering_port (unsigned k) const {return &port[k];}
+	void reflection (double const *a, double *b) const;
+	void derivatives (double const *a, double *jacobian) const;
 private:
 	void calculus ();
 };
@@ -87,13 +98,21 @@ struct diode
 {
 	diode (double Is, double nVT);
 	double current (double a) const;
+	double conductance (double a) const;
 	const double R, alpha, beta, gamma;
+private:
+	double lambert (double a) const;
 };
 
-struct diode_1p : diode, wave_module <1, electrical>
+struct diode_1p : diode, wave_module <1, electrical>, nonlinear_element
 {       
 	SC_HAS_PROCESS(diode_1p);
 	diode_1p (sc_core::sc_module_name name, double Vf, double If, double nVT = 0.025);
+	// nonlinear element description:
+	unsigned scattering_ports () const {return 1;}
+	const sc_core::sc_port_base *scattering_port (unsigned k) const {return &port;}
+	void reflection (double const *a, double *b) const;
+	void derivatives (double const *a, double *jacobian) const;
 private:
 	void calculus ();
 };
@@ -50,4 +50,87 @@ public: // internal variables used for tracing purposes only and initial conditi
 
 };
 
+
+// Induction motor model in the frame of the nature N, e.g., threephase_dq:
+// same parameters, states and equations as induction_motor, plus the -j w terms
+// that the stator and rotor fluxes gain in a frame rotating at speed w.
+// At synchronous frame speed the currents are constant in steady state, so that,
+// unlike induction_motor, the step is not fixed at 50 us: it ranges from a fiftieth
+// of the leakage time constant up to the rotor time constant.
+
+template <class N = threephase_dq>
+struct induction_motor_dq : wave_module <2, N, rotational>, analog_module
+{
+	SC_HAS_PROCESS(induction_motor_dq);
+	induction_motor_dq (sc_core::sc_module_name name, double rs=14.6, double rr=12.76, double Lleaks=0.02220211456132, double Lleakr=0.05180493397641, double Lmag=0.29629345238941, double P=4, double J=0.001, double B=0.000124);
+	ab_port <N> &supply;
+	ab_port <rotational> &load;
+private:
+	void field (double *var) const;
+	void calculus ();
+private: // motor parameters:
+	const double rs, rr, Lleaks, Lleakr, P, J, B, Lmag;
+public: // internal variables used for tracing purposes only and initial conditions
+	mutable double accel, Te;
+	void ics(double speed);
+};
+
+template <class N> induction_motor_dq<N>::induction_motor_dq (sc_core::sc_module_name name, double rs_in, double rr_in, double Lleaks_in, double Lleakr_in, double Lmag_in, double P_in, double J_in, double B_in) :
+analog_module(5, (Lleaks_in + Lleakr_in) / (rs_in + rr_in) / 50, (Lleakr_in + 1.5 * Lmag_in) / rr_in),
+supply(this->template port<N>(1)), load(this->template port<rotational>(2)), rs(rs_in), rr(rr_in),
+Lleaks(Lleaks_in), Lleakr(Lleakr_in), P(P_in), J(J_in), B(B_in), Lmag(Lmag_in)
+{
+	SC_THREAD(calculus); this->sensitive << this->activation;
+	supply <<= 1.0;
+	load   <<= 1.0;
+	Te = 0;
+	accel = 0;
+}
+
+template <class N> void induction_motor_dq<N>::ics (double speed)
+{
+	double ICS[5] = {0.0, 0.0, 0.0, 0.0, speed};
+	this->ic(ICS);
+}
+
+template <class N> void induction_motor_dq<N>::field (double *var) const
+{
+	const std::complex <double> j(0, 1);
+	const std::complex <double> jw(0, N::speed());
+	const double re = supply->get_normalization();
+	const double rm = load->get_normalization();
+	const double rmroot = sqrt(rm);
+	const double ls = Lleaks + 1.5*Lmag;
+	const double lr = Lleakr + 1.5*Lmag;
+	const double lm = 1.5*Lmag;
+	const double lx = ls * lr - lm * lm;
+
+	const std::complex <double> is(state[0], state[1]);
+	const std::complex <double> ir(state[2], state[3]);
+	const std::complex <double> vs = 2.0 * supply->read() - is;
+	const double omega = state[4];
+	const double torque = 2.0 * load->read() - omega;
+	std::complex <double> f1 = re * vs - rs * is - jw * (ls * is + lm * ir);
+	std::complex <double> f2 = (lm * is + lr * ir) * omega * P / 2.0 * j * rmroot - rr * ir - jw * (lm * is + lr * ir);
+	std::complex <double> v1 = lr / lx * f1 - lm / lx * f2;
+	std::complex <double> v2 = ls / lx * f2 - lm / lx * f1;
+
+	Te =  P / (2 / rmroot) * lm / re * (is * std::conj(ir)).imag();
+	accel =  Te / rm / J - (B * omega - torque / rm) / J;
+
+	var[0] = v1.real();
+	var[1] = v1.imag();
+	var[2] = v2.real();
+	var[3] = v2.imag();
+	var[4] = accel;
+}
+
+template <class N> void induction_motor_dq<N>::calculus ()
+{
+	while (step()) {
+		supply->write(supply->read() - std::complex<double>(state[0], state[1]));
+		load->write(state[4] - load->read());
+	}
+}
+
 #endif //ELECTROMECHANICAL_H
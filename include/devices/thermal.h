@@ -182,15 +182,18 @@ struct P_load_var_th : wave_module<2, T1, thermal>
 	ab_port <T1>      &tmpl_port;
 	ab_port <thermal> &thrm_port;
 	sc_core::sc_in <typename T1::wave_type> P_port;
+	// keep the electrical port matched to P (renormalizing it at every change):
+	void rematch (bool enable = true) {matched = enable;}
 private:
 	void calculus ();
 	void set_P ();
 	double P;
+	bool matched;
 };
 
 //	Implementation of class P_load_var_th:
 
-template <class T1> P_load_var_th<T1>::P_load_var_th (sc_core::sc_module_name name) :tmpl_port(base_class::port<T1>(1)), thrm_port(base_class::port<thermal>(2))
+template <class T1> P_load_var_th<T1>::P_load_var_th (sc_core::sc_module_name name) :tmpl_port(base_class::port<T1>(1)), thrm_port(base_class::port<thermal>(2)), matched(false)
 {
 	SC_METHOD(calculus);
 	this->sensitive << this->activation;
@@ -205,6 +208,7 @@ template <class T1> P_load_var_th<T1>::P_load_var_th (sc_core::sc_module_name na
 template <class T1> void P_load_var_th<T1>::set_P ()
 {
 	P = P_port->read();
+	if (matched && P > 0) tmpl_port.renormalize(P);
 }
 
 template <class T1> void P_load_var_th<T1>::calculus ()
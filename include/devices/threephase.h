@@ -69,6 +69,18 @@
 // c2vect(sc_core::sc_module_name name)
 // A module to convert a complex channel to two double channel; useful to convert a Clarke complex in the two vector components.
 
+// Frame-aware devices, for the natures park<F> (default threephase_dq) rotating with a reference frame:
+// their states are the dq components of fluxes and charges, which are constant in balanced steady state
+// at the speed of the frame, so that the step size is limited only by the transients.
+// R_load_dq, Rs_2s_dq, switch_2s_dq, RCs_load_dq, RLCs_2s_dq, RLs_2s_dq, LsCp_ladder_dq, RLs_load_dq
+// have the same parameters as their _tph counterparts.
+
+// clarke2park (sc_core::sc_module_name name, double max_angle = 0.01)
+// A module to connect a stationary threephase channel to a channel in the frame of the nature N.
+// Besides on port changes, the rotation is re-evaluated whenever the frame has turned by max_angle
+// (in radians), so a constant wave on either side is followed as well; while both incident waves
+// are zero there is nothing to rotate, and the module waits for a port change instead.
+
 
 typedef P_load<threephase>  R_load_tph;
 typedef Ps_2s<threephase>  Rs_2s_tph;
@@ -216,4 +228,287 @@ private:
 	std::complex<double> tmp;
 };
 
+
+// Frame-aware devices:
+// in a frame rotating at speed w, the derivative of a stored flux or charge x
+// seen from the frame gains the term -j w x, which is the only difference from
+// the stationary devices above.
+
+template <class N = threephase_dq> using R_load_dq = P_load<N>;
+template <class N = threephase_dq> using Rs_2s_dq = Ps_2s<N>;
+template <class N = threephase_dq> using switch_2s_dq = controlled_switch_2s<N>;
+
+
+//	Declaration of class RCs_load_dq
+
+template <class N = threephase_dq>
+struct RCs_load_dq : wave_module<1, N>, analog_module
+{
+	SC_HAS_PROCESS(RCs_load_dq);
+	RCs_load_dq (sc_core::sc_module_name name, double proportional_element, double derivative_element);
+public:
+	void ics (std::complex <double> const &VC0);
+private:
+	void calculus ();
+	void field (double *var) const;
+	const double R, C;
+};
+
+//	Implementation of class RCs_load_dq:
+
+template <class N> RCs_load_dq<N>::RCs_load_dq (sc_core::sc_module_name name, double proportional_element, double derivative_element) : analog_module(2, derivative_element / proportional_element / 100, derivative_element / proportional_element / 10), R(proportional_element), C(derivative_element)
+{
+	SC_THREAD(calculus);
+	this->sensitive << this->activation;
+}
+
+template <class N> void RCs_load_dq<N>::ics (std::complex <double> const &VC0)
+{
+	double ICS[2] = {C * VC0.real(), C * VC0.imag()};
+	this->ic(ICS);
+}
+
+template <class N> void RCs_load_dq<N>::field (double *var) const
+{
+	const std::complex <double> jw(0, N::speed());
+	const double R0 = this->port->get_normalization();
+	const double sqrt_R0 = this->port->get_normalization_sqrt();
+	const std::complex <double> q(state[0], state[1]);
+	std::complex <double> cvar = (2.0 * this->port->read() * sqrt_R0 - q / C) / (R + R0) - jw * q;
+	var[0] = cvar.real();
+	var[1] = cvar.imag();
+}
+
+template <class N> void RCs_load_dq<N>::calculus ()
+{
+	const double R0 = this->port->get_normalization();
+	const double sqrt_R0 = this->port->get_normalization_sqrt();
+	while (step())
+		this->port->write((this->port->read() * (R - R0) + std::complex <double>(state[0], state[1]) * sqrt_R0 / C) / (R + R0));
+}
+
+
+//	Declaration of class RLCs_2s_dq
+
+template <class N = threephase_dq>
+struct RLCs_2s_dq : wave_module<2, N>, analog_module
+{
+	SC_HAS_PROCESS(RLCs_2s_dq);
+	RLCs_2s_dq (sc_core::sc_module_name name, double proportional_element, double derivative_element, double integrative_element);
+	ab_port <N> &p1, &p2;
+private:
+	void field (double *var) const;
+	void calculus ();
+	const double P, D, I;
+};
+
+//	Implementation of class RLCs_2s_dq:
+
+template <class N> RLCs_2s_dq<N>::RLCs_2s_dq (sc_core::sc_module_name name, double proportional_element, double derivative_element, double integrative_element) : analog_module(4, sqrt(derivative_element * integrative_element) / 1000, sqrt(derivative_element * integrative_element) / 10), p1(this->port(1)), p2(this->port(2)), P(proportional_element), D(derivative_element), I(integrative_element)
+{
+	SC_THREAD(calculus);
+	this->sensitive << this->activation;
+	p1 <<= 5.0;
+	p2 <<= 5.0;
+}
+
+template <class N> void RLCs_2s_dq<N>::field (double *var) const
+{
+	const std::complex <double> jw(0, N::speed());
+	const double sqrt_P0 = p1->get_normalization_sqrt();
+	const double P0 = p1->get_normalization();
+	const std::complex <double> flux(state[0], state[1]), charge(state[2], state[3]);
+	std::complex <double> cvar1 = 2.0 * (p1->read() - p2->read()) * sqrt_P0 - flux / D * (2.0 * P0 + P) - charge / I - jw * flux;
+	std::complex <double> cvar2 = flux / D - jw * charge;
+	var[0] = cvar1.real();
+	var[1] = cvar1.imag();
+	var[2] = cvar2.real();
+	var[3] = cvar2.imag();
+}
+
+template <class N> void RLCs_2s_dq<N>::calculus ()
+{
+	const double sqrt_P0 = p1->get_normalization_sqrt();
+	while (step()) {
+		p1->write(p1->read() - sqrt_P0 / D * std::complex <double>(state[0], state[1]));
+		p2->write(p2->read() + sqrt_P0 / D * std::complex <double>(state[0], state[1]));
+	}
+}
+
+
+//	Declaration of class RLs_2s_dq
+
+template <class N = threephase_dq>
+struct RLs_2s_dq : wave_module<2, N>, analog_module
+{
+	SC_HAS_PROCESS(RLs_2s_dq);
+	RLs_2s_dq (sc_core::sc_module_name name, double proportional_element, double derivative_element);
+private:
+	void calculus ();
+	void field (double *var) const;
+	const double R, L;
+};
+
+//	Implementation of class RLs_2s_dq:
+
+template <class N> RLs_2s_dq<N>::RLs_2s_dq (sc_core::sc_module_name name, double proportional_element, double derivative_element) : analog_module(2, derivative_element / proportional_element / 100, derivative_element / proportional_element / 10), R(proportional_element), L(derivative_element)
+{
+	SC_THREAD(calculus);
+	this->sensitive << this->activation;
+	this->port(1) <<= 5;
+	this->port(2) <<= 5;
+}
+
+template <class N> void RLs_2s_dq<N>::field (double *var) const
+{
+	const std::complex <double> jw(0, N::speed());
+	const double sqrt_P0 = this->port(1)->get_normalization_sqrt();
+	const double P0 = this->port(1)->get_normalization();
+	const std::complex <double> flux(state[0], state[1]);
+	std::complex <double> cvar = 2 * sqrt_P0 * (this->port(1)->read() - this->port(2)->read()) - flux * (2 * P0 + R) / L - jw * flux;
+	var[0] = cvar.real();
+	var[1] = cvar.imag();
+}
+
+template <class N> void RLs_2s_dq<N>::calculus ()
+{
+	const double sqrt_P0 = this->port(1)->get_normalization_sqrt();
+	while (step()) {
+		this->port(1)->write(this->port(1)->read() - std::complex <double>(state[0], state[1]) * sqrt_P0 / L);
+		this->port(2)->write(this->port(2)->read() + std::complex <double>(state[0], state[1]) * sqrt_P0 / L);
+	}
+}
+
+
+//	Declaration of class LsCp_ladder_dq
+
+template <class N = threephase_dq>
+struct LsCp_ladder_dq : wave_module<2, N>, analog_module
+{
+	SC_HAS_PROCESS(LsCp_ladder_dq);
+	LsCp_ladder_dq (sc_core::sc_module_name name, double s_L, double p_C);
+	ab_port <N> &s, &p;
+private:
+	void calculus ();
+	void field (double *var) const;
+	const double C, L;
+};
+
+//	Implementation of class LsCp_ladder_dq:
+
+template <class N> LsCp_ladder_dq<N>::LsCp_ladder_dq (sc_core::sc_module_name name, double s_L, double p_C) : analog_module(4, sqrt(p_C * s_L) / 1000, sqrt(p_C * s_L) / 10), s(this->port(1)), p(this->port(2)), C(p_C), L(s_L)
+{
+	SC_THREAD(calculus);
+	this->sensitive << this->activation;
+	s <<= 5.0;
+	p <<= 5.0;
+}
+
+template <class N> void LsCp_ladder_dq<N>::field (double *var) const
+{
+	const std::complex <double> jw(0, N::speed());
+	const double sqrt_R1 = s->get_normalization_sqrt();
+	const double R1 = s->get_normalization();
+	const double sqrt_R2 = p->get_normalization_sqrt();
+	const double R2 = p->get_normalization();
+	const std::complex <double> charge(state[0], state[1]), flux(state[2], state[3]);
+	std::complex <double> v01 = flux / L + 2.0 * p->read() / sqrt_R2 - charge / (R2 * C) - jw * charge;
+	std::complex <double> v23 = 2.0 * s->read() * sqrt_R1 - (R1 / L) * flux - charge / C - jw * flux;
+	var[0] = v01.real();
+	var[1] = v01.imag();
+	var[2] = v23.real();
+	var[3] = v23.imag();
+}
+
+template <class N> void LsCp_ladder_dq<N>::calculus ()
+{
+	const double sqrt_R1 = s->get_normalization_sqrt();
+	const double sqrt_R2 = p->get_normalization_sqrt();
+	while (step()) {
+		s->write(s->read() - (sqrt_R1 / L) * std::complex <double>(state[2], state[3]));
+		p->write(-p->read() + std::complex <double>(state[0], state[1]) / (sqrt_R2 * C));
+	}
+}
+
+
+//	Declaration of class RLs_load_dq
+
+template <class N = threephase_dq>
+struct RLs_load_dq : wave_module<1, N>, analog_module
+{
+	SC_HAS_PROCESS(RLs_load_dq);
+	RLs_load_dq (sc_core::sc_module_name name, double s_R, double s_L);
+private:
+	void calculus ();
+	void field (double *var) const;
+	const double R, L;
+};
+
+//	Implementation of class RLs_load_dq:
+
+template <class N> RLs_load_dq<N>::RLs_load_dq (sc_core::sc_module_name name, double s_R, double s_L) : analog_module(2, s_L / s_R / 50, s_L / s_R), R(s_R), L(s_L)
+{
+	SC_THREAD(calculus);
+	this->sensitive << this->activation;
+}
+
+template <class N> void RLs_load_dq<N>::field (double *var) const
+{
+	const std::complex <double> jw(0, N::speed());
+	const double R0 = this->port->get_normalization();
+	const double sqrt_R0 = this->port->get_normalization_sqrt();
+	const std::complex <double> flux(state[0], state[1]);
+	std::complex <double> v01 = 2.0 * this->port->read() * sqrt_R0 - flux * (R + R0) / L - jw * flux;
+	var[0] = v01.real();
+	var[1] = v01.imag();
+}
+
+template <class N> void RLs_load_dq<N>::calculus ()
+{
+	const double sqrt_R0 = this->port->get_normalization_sqrt();
+	while (step())
+		this->port->write(this->port->read() - std::complex <double>(state[0], state[1]) * sqrt_R0 / L);
+}
+
+
+//	Declaration of class clarke2park
+//  The stationary and the rotating voltages are related by v_dq = v exp(-j angle),
+//  and the currents likewise with the opposite orientation, so that no power is lost.
+
+template <class N = threephase_dq>
+struct clarke2park : wave_module<2, threephase, N>
+{
+	SC_HAS_PROCESS(clarke2park);
+	clarke2park (sc_core::sc_module_name name, double max_angle = 0.01);
+	ab_port <threephase> &clarke;
+	ab_port <N> &dq;
+private:
+	void calculus ();
+	sc_core::sc_event rotation;
+	const double max_angle;
+};
+
+//	Implementation of class clarke2park:
+
+template <class N> clarke2park<N>::clarke2park (sc_core::sc_module_name name, double max_angle) : clarke(this->template port<threephase>(1)), dq(this->template port<N>(2)), max_angle(max_angle)
+{
+	SC_METHOD(calculus);
+	this->sensitive << this->activation << rotation;
+}
+
+template <class N> void clarke2park<N>::calculus ()
+{
+	const std::complex <double> r = std::polar(1.0, -N::angle(sc_core::sc_time_stamp().to_seconds()));
+	const double k2 = clarke->get_normalization() / dq->get_normalization();
+	const double k = sqrt(k2);
+	const std::complex <double> a1 = clarke->read();
+	const std::complex <double> a2 = dq->read();
+	clarke->write((2.0 * k * a2 * std::conj(r) + (1 - k2) * a1) / (1 + k2));
+	dq->write((2.0 * k * a1 * r + (k2 - 1) * a2) / (1 + k2));
+	// the next evaluation is due at the latest when the frame has turned by max_angle:
+	rotation.cancel();
+	if (N::speed() != 0 && (a1 != 0.0 || a2 != 0.0))
+		rotation.notify(max_angle / std::abs(N::speed()), sc_core::SC_SEC);
+}
+
 #endif //THREEPHASE_H
@@ -16,11 +16,60 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
 
+#define SC_INCLUDE_DYNAMIC_PROCESSES
 #include "systemc.h"
 #include "analog_system"
 #include <algorithm>
 #include <cstring>
 
+// Implementation of class activation_coalescer:
+
+bool activated_module::coalescing = false;
+
+activation_coalescer &activation_coalescer::instance ()
+{
+	// created at the first activation, the settling process is spawned by a running process:
+	static activation_coalescer *coalescer = new activation_coalescer;
+	return *coalescer;
+}
+
+activation_coalescer::activation_coalescer () : retries(0), scheduled(false)
+{
+	sc_core::sc_spawn_options options;
+	options.spawn_method();
+	options.dont_initialize();
+	options.set_sensitivity(&trigger);
+	sc_core::sc_spawn(sc_bind(&activation_coalescer::settle, this), sc_core::sc_gen_unique_name("activation_coalescer"), &options);
+}
+
+void activation_coalescer::defer (activated_module *module)
+{
+	if (module->deferred) return;
+	module->deferred = true;
+	waiting.push_back(module);
+	if (scheduled) return;
+	scheduled = true;
+	retries = 0;
+	trigger.notify(sc_core::SC_ZERO_TIME);
+}
+
+void activation_coalescer::settle ()
+{
+	// the waves are still moving as long as anything else is pending at the present time:
+	const unsigned patience = 1000;
+	if (sc_core::sc_pending_activity_at_current_time() && ++retries < patience) {
+		trigger.notify(sc_core::SC_ZERO_TIME);
+		return;
+	}
+	scheduled = false;
+	std::vector <activated_module *> ready;
+	ready.swap(waiting);
+	for (unsigned m = 0; m < ready.size(); ++m) {
+		ready[m]->deferred = false;
+		ready[m]->activation.notify();
+	}
+}
+
 // ATTENTION: multistep_b must not be shorter than multistep_c!
 #ifndef ODE_METHOD
 #error No ODE solver method specified in ODE_METHOD
@@ -67,6 +116,8 @@ const int analog_module::multistep_order_c = sizeof analog_module::multistep_c /
 analog_module::analog_module (int size, double min, double max) :
 	abstol(init_array(size, 1e-12)), reltol(1e-6), mintol(1e-1), size(size)
 {
+	coalesced = true;
+	precision = reltol;
   	dt_factor = 1.1; // factor must be > 1, otherwise may loop forever!
 	direction = init_array(size * multistep_order_b, 0.0);
 	state = init_array(size * (multistep_order_a + !!multistep_order_c), 0.0);
@@ -96,6 +147,7 @@ void analog_module::set_tolerances (double const *abstol, double reltol, double
 	for (int i = 0; i < size; ++i)
 		this->abstol[i] = abstol[i];
 	this->reltol = reltol;
+	precision = reltol;
 	this->mintol = mintol;
 }
 
@@ -104,6 +156,7 @@ void analog_module::set_tolerances (double abstol, double reltol, double mintol)
 	for (int i = 0; i < size; ++i)
 		this->abstol[i] = abstol;
 	this->reltol = reltol;
+	precision = reltol;
 	this->mintol = mintol;
 }
 
@@ -217,6 +270,8 @@ bool analog_module::step ()
 analog_module::analog_module (int size, double min, double max):
 	abstol(init_array(size, 1e-12)), reltol(1e-6), size(size),h(1e-6) 
 {
+	coalesced = true;
+	precision = reltol;
 	state = init_array(size , 0.0);
 	K = gsl_odeiv_step_bsimp;	//set step type to Bulirsch-Stoer 
 	s = gsl_odeiv_step_alloc (K, size);	//allocate step type
@@ -83,6 +83,22 @@ double mosfet::current (double a, bool gate) const
 	return y * gamma;
 }
 
+double mosfet::conductance (double a, bool gate) const
+{
+	// derivative of current() with respect to a:
+	double x = a * alpha;
+	if (gate && x - beta >= 1) {
+		return 0;
+	} else if (gate && x >= 0) {
+		double c2 = beta * beta;
+		double c1 = 0.5 + beta * (1 - x);
+		double c0 = x * x - 2 * x;
+		double d = 2 * c1 * -beta - (2 * x - 2) * c2;
+		return (d / (2 * sqrt(c1 * c1 - c0 * c2)) + beta) / c2 * alpha * gamma;
+	}
+	return 0;
+}
+
 
 /*	Implementation of the diode model:
  *	 i = Is * (exp(v / nVT) - 1)
@@ -118,13 +134,26 @@ double diode::current (double a) const
 		// Just pretend to be a fixed voltage source:
 		return a + a - 400 / alpha;
 	}
+	return gamma * (lambert(a) / beta - 1);
+}
+
+double diode::conductance (double a) const
+{
+	// derivative of current() with respect to a, using dW/dx = W / (x * (1 + W)):
+	if (a * alpha > 400) return 2;
+	double w = lambert(a);
+	return gamma / beta * alpha * w / (1 + w);
+}
+
+double diode::lambert (double a) const
+{
 	double x = beta * exp(a * alpha + beta);
 	// compute Lambert-W function W0(x),
 	// five Newton-Raphson iterations usually suffice:
 	double w = x > 2 ? log(x) - log(log(x)) : 0.5;
 	for (int n = 0; n < 5; ++n)
 		w = (x * exp(-w) + w * w) / (w + 1);
-	return gamma * (w / beta - 1);
+	return w;
 }
 
 
@@ -136,10 +165,22 @@ mosfet_1p::mosfet_1p (sc_core::sc_module_name name, double Vsat, double Isat) :
 	SC_METHOD(calculus);
 	sensitive << activation << control;
 	port <<= R;
+	port.nominal(R);
+}
+
+void mosfet_1p::reflection (double const *a, double *b) const
+{
+	b[0] = a[0] - current(a[0], control->read());
+}
+
+void mosfet_1p::derivatives (double const *a, double *jacobian) const
+{
+	jacobian[0] = 1 - conductance(a[0], control->read());
 }
 
 void mosfet_1p::calculus ()
 {
+	if (control.event() && changed()) return;
 	bool gate = control->read();
 	double a = port->read();
 	double i = current(a, gate);
@@ -153,10 +194,27 @@ mosfet_2p::mosfet_2p (sc_core::sc_module_name name, double Vsat, double Isat) :
 	sensitive << activation << control;
 	port[0] <<= R;
 	port[1] <<= R;
+	port[0].nominal(R);
+	port[1].nominal(R);
+}
+
+void mosfet_2p::reflection (double const *a, double *b) const
+{
+	double i = current(a[0] - a[1], control->read());
+	b[0] = a[0] - i;
+	b[1] = a[1] + i;
+}
+
+void mosfet_2p::derivatives (double const *a, double *jacobian) const
+{
+	double g = conductance(a[0] - a[1], control->read());
+	jacobian[0] = jacobian[3] = 1 - g;
+	jacobian[1] = jacobian[2] = g;
 }
 
 void mosfet_2p::calculus ()
 {
+	if (control.event() && changed()) return;
 	bool gate = control->read();
 	double a1 = port[0]->read();
 	double a2 = port[1]->read();
@@ -171,6 +229,17 @@ diode_1p::diode_1p (sc_core::sc_module_name name, double Vf, double If, double n
 	SC_METHOD(calculus);
 	sensitive << activation;
 	port <<= R;
+	port.nominal(R);
+}
+
+void diode_1p::reflection (double const *a, double *b) const
+{
+	b[0] = a[0] - current(a[0]);
+}
+
+void diode_1p::derivatives (double const *a, double *jacobian) const
+{
+	jacobian[0] = 1 - conductance(a[0]);
 }
 
 void diode_1p::calculus ()
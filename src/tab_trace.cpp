@@ -20,6 +20,15 @@
 #include "tab_trace"
 #include <vector>
 #include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 class trace_devirtualizer : public sc_core::sc_trace_file
 {
@@ -51,6 +60,151 @@ class trace_devirtualizer : public sc_core::sc_trace_file
 	void trace(const unsigned& object, const std::string& name, const char** enum_literals) {}
 };
 
+
+// Definition of class trace_writer:
+/*
+	moves the output of a trace file to a background thread. The
+	simulation thread fills the blocks of a ring, all allocated at
+	construction, and hands them over to the writer thread through two
+	counters (single producer, single consumer), so it never waits on
+	the file system. The writer thread turns each block into the bytes
+	of the file with the given formatter and writes them with an
+	unbuffered stream, in multiples of the block size. If all the blocks
+	are queued because the writer falls behind, the simulation waits for
+	one to be freed rather than dropping samples. close() queues the
+	partial block, waits for the writer to drain the ring, writes the
+	remainder and closes the file. Write errors are reported once, from
+	the simulation thread. The trace files still open when the program
+	exits are closed from an atexit handler (see close_open_trace_files),
+	as the writer threads would otherwise be killed with their last blocks.
+*/
+class trace_writer
+{
+public:
+	typedef void (*formatter) (unsigned char const *data, size_t size, std::string &out);
+	trace_writer (FILE *f, formatter format, size_t block_size = 1 << 20, unsigned blocks = 4);
+	~trace_writer () {close();}
+	unsigned char *reserve (size_t size);
+	void write (void const *data, size_t size);
+	void close ();
+	static void raw (unsigned char const *data, size_t size, std::string &out) {out.append((char const *) data, size);}
+private:
+	struct block {std::vector <unsigned char> data; size_t used;};
+	block &current () {return ring[head.load(std::memory_order_relaxed) % ring.size()];}
+	void publish ();
+	void run ();
+	FILE *f;
+	const formatter format;
+	const size_t block_size;
+	std::vector <block> ring;
+	std::atomic <unsigned> head, tail; // blocks queued by the simulation and written by the writer
+	std::atomic <bool> failed;
+	bool closing, closed, warned;
+	std::mutex lock;
+	std::condition_variable queued, freed;
+	std::thread writer;
+};
+
+trace_writer::trace_writer (FILE *f, formatter format, size_t block_size, unsigned blocks) :
+	f(f), format(format), block_size(block_size), ring(blocks), head(0), tail(0), failed(false), closing(false), closed(false), warned(false)
+{
+	setvbuf(f, 0, _IONBF, 0);
+	for (unsigned i = 0; i < ring.size(); ++i) {
+		ring[i].data.resize(block_size);
+		ring[i].used = 0;
+	}
+	writer = std::thread(&trace_writer::run, this);
+}
+
+unsigned char *trace_writer::reserve (size_t size)
+{
+	if (current().used + size > current().data.size()) {
+		if (current().used) publish();
+		if (size > current().data.size()) current().data.resize(size);
+	}
+	block &b = current();
+	unsigned char *p = b.data.data() + b.used;
+	b.used += size;
+	return p;
+}
+
+void trace_writer::write (void const *data, size_t size)
+{
+	unsigned char const *p = (unsigned char const *) data;
+	while (size) {
+		block &b = current();
+		if (b.used == b.data.size()) {
+			publish();
+			continue;
+		}
+		const size_t n = std::min(size, b.data.size() - b.used);
+		memcpy(b.data.data() + b.used, p, n);
+		b.used += n;
+		p += n;
+		size -= n;
+	}
+}
+
+void trace_writer::publish ()
+{
+	const unsigned h = head.load(std::memory_order_relaxed) + 1;
+	head.store(h, std::memory_order_release);
+	{std::lock_guard <std::mutex> guard(lock);}
+	queued.notify_one();
+	if (h - tail.load(std::memory_order_acquire) == ring.size()) {
+		// backpressure: all the blocks are queued, wait for the writer to free one
+		std::unique_lock <std::mutex> guard(lock);
+		freed.wait(guard, [&] {return h - tail.load(std::memory_order_acquire) < ring.size();});
+	}
+	current().used = 0;
+	if (failed && !warned) {
+		SC_REPORT_WARNING("WMS", "cannot write to trace file, samples are being lost.");
+		warned = true;
+	}
+}
+
+void trace_writer::close ()
+{
+	if (closed) return;
+	if (current().used) {
+		head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+	{
+		std::lock_guard <std::mutex> guard(lock);
+		closing = true;
+	}
+	queued.notify_one();
+	writer.join();
+	closed = true;
+	if (failed && !warned) SC_REPORT_WARNING("WMS", "cannot write to trace file, samples have been lost.");
+}
+
+void trace_writer::run ()
+{
+	std::string out;
+	unsigned t = tail.load(std::memory_order_relaxed);
+	while (true) {
+		{
+			std::unique_lock <std::mutex> guard(lock);
+			queued.wait(guard, [&] {return head.load(std::memory_order_acquire) != t || closing;});
+		}
+		if (head.load(std::memory_order_acquire) == t) break; // closing, and nothing left
+		block const &b = ring[t % ring.size()];
+		format(b.data.data(), b.used, out);
+		const size_t n = out.size() / block_size * block_size;
+		if (n) {
+			if (fwrite(out.data(), 1, n, f) != n) failed = true;
+			out.erase(0, n);
+		}
+		tail.store(++t, std::memory_order_release);
+		{std::lock_guard <std::mutex> guard(lock);}
+		freed.notify_one();
+	}
+	if (!out.empty() && fwrite(out.data(), 1, out.size(), f) != out.size()) failed = true;
+	if (fclose(f)) failed = true;
+}
+
+
 class tab_trace_file : public trace_devirtualizer
 {
 public:
@@ -63,41 +217,79 @@ protected:
 	void delta_cycles (bool flag) {trace_deltas = flag;}
 	void cycle (bool delta_cycle);
 private:
-	FILE *f;
+	trace_writer *writer;
 	bool trace_deltas, initialized;
 	std::vector <const double *> traces;
 	std::vector <std::string> names;
 	double next_t, output_step;
 	void initialize ();
+	void write_text (std::string const &text);
+	// records are an int32 n followed by a row of n doubles, or by -n characters of text:
+	static void format (unsigned char const *data, size_t size, std::string &out);
 };
 
 tab_trace_file::tab_trace_file (const char *name, double minstep) : trace_deltas(false), initialized(false)
 {
 	std::string filename = name;
 	filename += ".txt";
+	FILE *f;
 	if (!(f = fopen(filename.c_str(), "w"))) {
-		std::cerr << "ERROR: Cannot open trace file \"" << filename << "\".\n";
-		throw;
+		const std::string message = "cannot open trace file \"" + filename + "\"";
+		SC_REPORT_ERROR("WMS", message.c_str());
+		throw std::runtime_error(message); // should errors have been set not to throw
 	}
+	writer = new trace_writer(f, format);
 	next_t = -1;
 	output_step = minstep;
 }
 
 tab_trace_file::~tab_trace_file ()
 {
-	if (f) fclose(f);
+	delete writer;
 }
 
 void tab_trace_file::initialize ()
 {
-	for (unsigned i = 0; i < names.size(); ++i)
-		fprintf(f, "# % 3d: %s\n", i + 2, names[i].c_str());
+	char line[32];
+	for (unsigned i = 0; i < names.size(); ++i) {
+		snprintf(line, sizeof line, "# % 3d: ", i + 2);
+		write_text(line + names[i] + "\n");
+	}
 	initialized = true;
 }
 
 void tab_trace_file::write_comment (std::string const &comment)
 {
-	fprintf(f, "# %s\n", comment.c_str());
+	write_text("# " + comment + "\n");
+}
+
+void tab_trace_file::write_text (std::string const &text)
+{
+	const int32_t n = -int32_t(text.size());
+	unsigned char *p = writer->reserve(sizeof n + text.size());
+	memcpy(p, &n, sizeof n);
+	memcpy(p + sizeof n, text.data(), text.size());
+}
+
+void tab_trace_file::format (unsigned char const *data, size_t size, std::string &out)
+{
+	char number[32];
+	for (unsigned char const *end = data + size; data < end; ) {
+		int32_t n;
+		memcpy(&n, data, sizeof n);
+		data += sizeof n;
+		if (n < 0) {
+			out.append((char const *) data, -n);
+			data += -n;
+			continue;
+		}
+		for (int32_t i = 0; i < n; ++i, data += sizeof (double)) {
+			double value;
+			memcpy(&value, data, sizeof value);
+			out.append(number, snprintf(number, sizeof number, i ? "\t%e" : "%e", value));
+		}
+		out += '\n';
+	}
 }
 
 void tab_trace_file::trace (double const &object, std::string const &name)
@@ -115,25 +307,329 @@ void tab_trace_file::cycle (bool this_is_a_delta_cycle)
 		if (t < next_t) return;
 		next_t = t + output_step;
 	}
-	fprintf(f, "%e", sc_core::sc_time_stamp().to_seconds());
+	const int32_t n = traces.size() + 1;
+	unsigned char *p = writer->reserve(sizeof n + n * sizeof (double));
+	memcpy(p, &n, sizeof n);
+	p += sizeof n;
+	memcpy(p, &t, sizeof t);
 	for (unsigned i = 0, j = traces.size(); i < j; ++i)
-		fprintf(f, "\t%e", *traces[i]);
-	fprintf(f, "\n");
+		memcpy(p += sizeof (double), traces[i], sizeof (double));
+}
+
+
+// Definition of class bin_trace_file:
+/*
+	a binary trace file with one typed column per traced object, for long
+	runs whose text traces would be huge and mostly spent in fprintf.
+	As the tab file, it is written by a trace_writer thread.
+	The samples are gathered column by column in blocks of up to "chunk"
+	rows, and each block is written as the consecutive arrays of its
+	columns. All numbers are in the byte order of the writer, which is
+	told by the byte order mark of the header. The layout is:
+
+	header: "WMSTRACE", uint32 byte order mark 0x01020304, uint32 version,
+	        uint32 number of columns, then for each column uint8 type,
+	        uint32 size of an element in bytes, int32 width in bits (-1 if
+	        not given), uint32 length and text of the name, uint32 number
+	        of enumeration literals, each as uint32 length and text.
+	        Column 0 is the simulation time in seconds.
+	block:  uint32 number of rows, then the arrays of all the columns.
+	footer: for each block, uint64 offset in the file, uint32 rows, and the
+	        double times of its first and last row; then uint32 number of
+	        comments, each as the double time it was written at and uint32
+	        length and text; then uint32 number of blocks, uint64 offset of
+	        the footer and "WMSINDEX", so that a reader can seek to any
+	        block starting from the end of the file.
+
+	Column types are listed in bin_trace_file::type: integers keep their
+	size and sign, fixed-point values and sc_signed or sc_unsigned wider
+	than 64 bits are stored as doubles, and bit and logic vectors are
+	stored as one character ('0', '1', 'Z' or 'X') per bit, MSB first.
+*/
+class bin_trace_file : public trace_devirtualizer
+{
+public:
+	enum type {t_bool = 1, t_int8, t_uint8, t_int16, t_uint16, t_int32, t_uint32, t_int64, t_uint64, t_float, t_double, t_logic, t_enum};
+	bin_trace_file (const char *name, double minstep, unsigned chunk);
+	void set_time_unit (double, sc_core::sc_time_unit) {}
+	~bin_trace_file ();
+protected:
+	void trace (const bool &object, const std::string &name) {add(new column_of<bool, uint8_t>(object, [] (bool const &x) {return uint8_t(x);}), t_bool, -1, name);}
+	void trace (const sc_dt::sc_bit &object, const std::string &name) {add(new column_of<sc_dt::sc_bit, uint8_t>(object, [] (sc_dt::sc_bit const &x) {return uint8_t(x.to_bool());}), t_bool, -1, name);}
+	void trace (const sc_dt::sc_logic &object, const std::string &name) {add(new column_of<sc_dt::sc_logic, char>(object, [] (sc_dt::sc_logic const &x) {return x.to_char();}), t_logic, 1, name);}
+	void trace (const unsigned char &object, const std::string &name, int width) {add(plain<uint8_t>(object), t_uint8, width, name);}
+	void trace (const unsigned short &object, const std::string &name, int width) {add(plain<uint16_t>(object), t_uint16, width, name);}
+	void trace (const unsigned int &object, const std::string &name, int width) {add(plain<uint32_t>(object), t_uint32, width, name);}
+	void trace (const unsigned long &object, const std::string &name, int width) {add(plain<uint64_t>(object), t_uint64, width, name);}
+	void trace (const char &object, const std::string &name, int width) {add(plain<int8_t>(object), t_int8, width, name);}
+	void trace (const short &object, const std::string &name, int width) {add(plain<int16_t>(object), t_int16, width, name);}
+	void trace (const int &object, const std::string &name, int width) {add(plain<int32_t>(object), t_int32, width, name);}
+	void trace (const long &object, const std::string &name, int width) {add(plain<int64_t>(object), t_int64, width, name);}
+	void trace (const sc_dt::int64 &object, const std::string &name, int width) {add(plain<int64_t>(object), t_int64, width, name);}
+	void trace (const sc_dt::uint64 &object, const std::string &name, int width) {add(plain<uint64_t>(object), t_uint64, width, name);}
+	void trace (const float &object, const std::string &name) {add(plain<float>(object), t_float, -1, name);}
+	void trace (const double &object, const std::string &name) {add(plain<double>(object), t_double, -1, name);}
+	void trace (const sc_dt::sc_uint_base &object, const std::string &name) {add(new column_of<sc_dt::sc_uint_base, uint64_t>(object, [] (sc_dt::sc_uint_base const &x) {return uint64_t(x.to_uint64());}), t_uint64, object.length(), name);}
+	void trace (const sc_dt::sc_int_base &object, const std::string &name) {add(new column_of<sc_dt::sc_int_base, int64_t>(object, [] (sc_dt::sc_int_base const &x) {return int64_t(x.to_int64());}), t_int64, object.length(), name);}
+	void trace (const sc_dt::sc_unsigned &object, const std::string &name);
+	void trace (const sc_dt::sc_signed &object, const std::string &name);
+	void trace (const sc_dt::sc_fxval &object, const std::string &name) {add(fixed(object), t_double, -1, name);}
+	void trace (const sc_dt::sc_fxval_fast &object, const std::string &name) {add(fixed(object), t_double, -1, name);}
+	void trace (const sc_dt::sc_fxnum &object, const std::string &name) {add(fixed(object), t_double, -1, name);}
+	void trace (const sc_dt::sc_fxnum_fast &object, const std::string &name) {add(fixed(object), t_double, -1, name);}
+	void trace (const sc_dt::sc_bv_base &object, const std::string &name) {add(new bits_of<sc_dt::sc_bv_base>(object), t_logic, object.length(), name);}
+	void trace (const sc_dt::sc_lv_base &object, const std::string &name) {add(new bits_of<sc_dt::sc_lv_base>(object), t_logic, object.length(), name);}
+	void trace (const unsigned &object, const std::string &name, const char **enum_literals);
+	void write_comment (std::string const &comment) {comments.push_back(std::make_pair(sc_core::sc_time_stamp().to_seconds(), comment));}
+	void delta_cycles (bool flag) {trace_deltas = flag;}
+	void cycle (bool delta_cycle);
+private:
+	struct column
+	{
+		column (unsigned size) : size(size) {}
+		virtual ~column () {}
+		virtual void sample (unsigned char *out) const = 0;
+		const unsigned size;
+		int type, width;
+		std::string name;
+		std::vector <std::string> literals;
+		std::vector <unsigned char> data;
+	};
+	template <class T, class S> struct column_of : column
+	{
+		column_of (T const &object, S (*get) (T const &)) : column(sizeof (S)), object(object), get(get) {}
+		void sample (unsigned char *out) const {S value = get(object); memcpy(out, &value, sizeof value);}
+		T const &object;
+		S (*get) (T const &);
+	};
+	template <class T> struct bits_of : column
+	{
+		bits_of (T const &object) : column(object.length()), object(object) {}
+		void sample (unsigned char *out) const {memcpy(out, object.to_string().c_str(), size);}
+		T const &object;
+	};
+	template <class S, class T> static column *plain (T const &object) {return new column_of<T, S>(object, [] (T const &x) {return S(x);});}
+	template <class T> static column *fixed (T const &object) {return new column_of<T, double>(object, [] (T const &x) {return x.to_double();});}
+	void add (column *c, int type, int width, std::string const &name);
+	void put (void const *data, size_t size) {writer->write(data, size); offset += size;}
+	void put_string (std::string const &text);
+	void initialize ();
+	void flush ();
+	struct block_entry {uint64_t offset; uint32_t rows; double first, last;};
+	trace_writer *writer;
+	bool trace_deltas, initialized;
+	std::vector <column *> columns;
+	std::vector <double> times;
+	std::vector <block_entry> blocks;
+	std::vector <std::pair <double, std::string> > comments;
+	uint64_t offset;
+	unsigned chunk;
+	double next_t, output_step;
+};
+
+bin_trace_file::bin_trace_file (const char *name, double minstep, unsigned chunk) : trace_deltas(false), initialized(false), offset(0), chunk(chunk ? chunk : 1)
+{
+	std::string filename = name;
+	filename += ".bin";
+	FILE *f;
+	if (!(f = fopen(filename.c_str(), "wb"))) {
+		const std::string message = "cannot open trace file \"" + filename + "\"";
+		SC_REPORT_ERROR("WMS", message.c_str());
+		throw std::runtime_error(message); // should errors have been set not to throw
+	}
+	writer = new trace_writer(f, trace_writer::raw);
+	next_t = -1;
+	output_step = minstep;
+	times.reserve(this->chunk);
+}
+
+bin_trace_file::~bin_trace_file ()
+{
+	if (!initialized) initialize();
+	flush();
+	const uint64_t footer = offset;
+	for (unsigned i = 0; i < blocks.size(); ++i) {
+		put(&blocks[i].offset, sizeof blocks[i].offset);
+		put(&blocks[i].rows, sizeof blocks[i].rows);
+		put(&blocks[i].first, sizeof blocks[i].first);
+		put(&blocks[i].last, sizeof blocks[i].last);
+	}
+	const uint32_t remarks = comments.size();
+	put(&remarks, sizeof remarks);
+	for (unsigned i = 0; i < comments.size(); ++i) {
+		put(&comments[i].first, sizeof comments[i].first);
+		put_string(comments[i].second);
+	}
+	const uint32_t count = blocks.size();
+	put(&count, sizeof count);
+	put(&footer, sizeof footer);
+	put("WMSINDEX", 8);
+	delete writer;
+	for (unsigned i = 0; i < columns.size(); ++i) delete columns[i];
+}
+
+void bin_trace_file::add (column *c, int type, int width, std::string const &name)
+{
+	if (initialized) {
+		SC_REPORT_WARNING("WMS", ("cannot add trace \"" + name + "\" to a binary trace file already started.").c_str());
+		delete c;
+		return;
+	}
+	c->type = type;
+	c->width = width;
+	c->name = name;
+	c->data.reserve(chunk * c->size);
+	columns.push_back(c);
+}
+
+void bin_trace_file::trace (const sc_dt::sc_unsigned &object, const std::string &name)
+{
+	if (object.length() <= 64)
+		add(new column_of<sc_dt::sc_unsigned, uint64_t>(object, [] (sc_dt::sc_unsigned const &x) {return uint64_t(x.to_uint64());}), t_uint64, object.length(), name);
+	else
+		add(new column_of<sc_dt::sc_unsigned, double>(object, [] (sc_dt::sc_unsigned const &x) {return x.to_double();}), t_double, object.length(), name);
+}
+
+void bin_trace_file::trace (const sc_dt::sc_signed &object, const std::string &name)
+{
+	if (object.length() <= 64)
+		add(new column_of<sc_dt::sc_signed, int64_t>(object, [] (sc_dt::sc_signed const &x) {return int64_t(x.to_int64());}), t_int64, object.length(), name);
+	else
+		add(new column_of<sc_dt::sc_signed, double>(object, [] (sc_dt::sc_signed const &x) {return x.to_double();}), t_double, object.length(), name);
+}
+
+void bin_trace_file::trace (const unsigned &object, const std::string &name, const char **enum_literals)
+{
+	add(plain<uint32_t>(object), t_enum, -1, name);
+	for (int i = 0; enum_literals && enum_literals[i]; ++i)
+		columns.back()->literals.push_back(enum_literals[i]);
+}
+
+void bin_trace_file::put_string (std::string const &text)
+{
+	const uint32_t length = text.size();
+	put(&length, sizeof length);
+	put(text.data(), length);
+}
+
+void bin_trace_file::initialize ()
+{
+	const uint32_t bom = 0x01020304, version = 1, count = columns.size() + 1;
+	put("WMSTRACE", 8);
+	put(&bom, sizeof bom);
+	put(&version, sizeof version);
+	put(&count, sizeof count);
+	for (unsigned i = 0; i < count; ++i) {
+		const uint8_t type = i ? columns[i - 1]->type : t_double;
+		const uint32_t size = i ? columns[i - 1]->size : sizeof (double);
+		const int32_t width = i ? columns[i - 1]->width : -1;
+		put(&type, sizeof type);
+		put(&size, sizeof size);
+		put(&width, sizeof width);
+		put_string(i ? columns[i - 1]->name : "time");
+		const uint32_t literals = i ? columns[i - 1]->literals.size() : 0;
+		put(&literals, sizeof literals);
+		for (unsigned k = 0; k < literals; ++k)
+			put_string(columns[i - 1]->literals[k]);
+	}
+	initialized = true;
+}
+
+void bin_trace_file::flush ()
+{
+	if (times.empty()) return;
+	const block_entry entry = {offset, uint32_t(times.size()), times.front(), times.back()};
+	blocks.push_back(entry);
+	put(&entry.rows, sizeof entry.rows);
+	put(times.data(), times.size() * sizeof (double));
+	times.clear();
+	for (unsigned i = 0; i < columns.size(); ++i) {
+		put(columns[i]->data.data(), columns[i]->data.size());
+		columns[i]->data.clear();
+	}
+}
+
+void bin_trace_file::cycle (bool this_is_a_delta_cycle)
+{
+	if (this_is_a_delta_cycle && !trace_deltas) return;
+	if (!initialized) initialize();
+	double t = sc_core::sc_time_stamp().to_seconds();
+	if (output_step > 0) {
+		if (t < next_t) return;
+		next_t = t + output_step;
+	}
+	times.push_back(t);
+	for (unsigned i = 0; i < columns.size(); ++i) {
+		column &c = *columns[i];
+		c.data.resize(c.data.size() + c.size);
+		c.sample(c.data.data() + c.data.size() - c.size);
+	}
+	if (times.size() >= chunk) flush();
 }
 
 
 // auxiliary functions:
 
+// the trace files not closed yet, each with the function closing it:
+typedef std::vector <std::pair <sc_core::sc_trace_file *, void (*) (sc_core::sc_trace_file *)> > open_trace_files;
+
+static open_trace_files &opened ()
+{
+	// never destroyed, as it is still used by the atexit handler:
+	static open_trace_files *files = new open_trace_files;
+	return *files;
+}
+
+static void close_open_trace_files ()
+{
+	// at exit, the trace files left open get their tails written and their files closed:
+	while (!opened().empty())
+		opened().back().second(opened().back().first);
+}
+
+static void opening (sc_core::sc_trace_file *f, void (*close) (sc_core::sc_trace_file *))
+{
+	static bool registered = false;
+	if (!registered) registered = !std::atexit(close_open_trace_files);
+	opened().push_back(std::make_pair(f, close));
+}
+
+static void closing (sc_core::sc_trace_file *f)
+{
+	for (open_trace_files::iterator i = opened().begin(); i != opened().end(); ++i)
+		if (i->first == f) {
+			opened().erase(i);
+			return;
+		}
+}
+
 sc_core::sc_trace_file *create_tab_trace_file (const char *name, double minstep)
 {
 	sc_core::sc_trace_file *t = new tab_trace_file(name, minstep);
 	// simcontext is deprecated in version 2.1, is there another way?
 	sc_core::sc_get_curr_simcontext()->add_trace_file(t);
+	opening(t, close_tab_trace_file);
 	return t;
 }
 
 void close_tab_trace_file (sc_core::sc_trace_file *f)
 {
+	closing(f);
 	tab_trace_file *t = (tab_trace_file *) f;
 	delete t;
 }
+
+sc_core::sc_trace_file *create_bin_trace_file (const char *name, double minstep, unsigned chunk)
+{
+	sc_core::sc_trace_file *t = new bin_trace_file(name, minstep, chunk);
+	sc_core::sc_get_curr_simcontext()->add_trace_file(t);
+	opening(t, close_bin_trace_file);
+	return t;
+}
+
+void close_bin_trace_file (sc_core::sc_trace_file *f)
+{
+	closing(f);
+	bin_trace_file *t = (bin_trace_file *) f;
+	delete t;
+}
@@ -17,6 +17,13 @@
 */
 
 #include "wave_system"
+#include <algorithm>
+#include <map>
+#include <vector>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WAVE_KERNELS_X86
+#include <immintrin.h>
+#endif
 
 #ifdef HAVE_LAPACK
 // This file depends on LAPACK solvers
@@ -33,73 +40,722 @@ extern "C" void dgesv_ ( // general solver of linear equations
 
 ab_signal_memory ab_signal_memory::state = 0;
 
+// Implementation of class wave_kernels:
+
+namespace {
+
+// Scalar reference, summing in the same order as the generic junction loops:
+
+template <class S> void weighted_sum_scalar (S const *b, S const *beta, unsigned n, unsigned width, S *sum)
+{
+	for (unsigned w = 0; w < width; ++w) sum[w] = 0;
+	for (unsigned j = 0; j < n; ++j)
+		for (unsigned w = 0; w < width; ++w)
+			sum[w] += b[j * width + w] * beta[j];
+}
+
+template <class S> void reflect_scalar (S const *b, S const *beta, S const *sum, S sign, unsigned n, unsigned width, S *out)
+{
+	for (unsigned j = 0; j < n; ++j)
+		for (unsigned w = 0; w < width; ++w)
+			out[j * width + w] = (sum[w] * beta[j] - b[j * width + w]) * sign;
+}
+
+template <class S> void transpose_product_scalar (double const *matrix, unsigned stride, S const *b, unsigned n, unsigned width, S *out)
+{
+	for (unsigned k = 0; k < n * width; ++k) out[k] = 0;
+	for (unsigned i = 0; i < n; ++i)
+		for (unsigned j = 0; j < n; ++j)
+			for (unsigned w = 0; w < width; ++w)
+				out[j * width + w] += matrix[i * stride + j] * b[i * width + w];
+}
+
+#ifdef WAVE_KERNELS_X86
+
+// AVX2 kernels: real waves are processed four ports at a time,
+// complex ones two ports at a time, wider waves four doubles at a time.
+// Any other width falls back to the scalar code.
+
+__attribute__((target("avx2,fma"))) inline __m256d pairs_avx2 (double const *x)
+{
+	// {x[0], x[0], x[1], x[1]}:
+	return _mm256_permute4x64_pd(_mm256_castpd128_pd256(_mm_loadu_pd(x)), 0x50);
+}
+
+__attribute__((target("avx2,fma"))) void weighted_sum_avx2 (double const *b, double const *beta, unsigned n, unsigned width, double *sum)
+{
+	double lane[4];
+	unsigned j = 0;
+	if (width == 1) {
+		__m256d acc = _mm256_setzero_pd();
+		for (; j + 4 <= n; j += 4)
+			acc = _mm256_fmadd_pd(_mm256_loadu_pd(b + j), _mm256_loadu_pd(beta + j), acc);
+		_mm256_storeu_pd(lane, acc);
+		sum[0] = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+	} else if (width == 2) {
+		__m256d acc = _mm256_setzero_pd();
+		for (; j + 2 <= n; j += 2)
+			acc = _mm256_fmadd_pd(_mm256_loadu_pd(b + 2 * j), pairs_avx2(beta + j), acc);
+		_mm256_storeu_pd(lane, acc);
+		sum[0] = lane[0] + lane[2];
+		sum[1] = lane[1] + lane[3];
+	} else if (width % 4 == 0) {
+		for (unsigned w = 0; w < width; w += 4) {
+			__m256d acc = _mm256_setzero_pd();
+			for (unsigned i = 0; i < n; ++i)
+				acc = _mm256_fmadd_pd(_mm256_loadu_pd(b + i * width + w), _mm256_set1_pd(beta[i]), acc);
+			_mm256_storeu_pd(sum + w, acc);
+		}
+		return;
+	} else
+		return weighted_sum_scalar(b, beta, n, width, sum);
+	for (; j < n; ++j)
+		for (unsigned w = 0; w < width; ++w)
+			sum[w] += b[j * width + w] * beta[j];
+}
+
+__attribute__((target("avx2,fma"))) void reflect_avx2 (double const *b, double const *beta, double const *sum, double sign, unsigned n, unsigned width, double *out)
+{
+	const __m256d s = _mm256_set1_pd(sign);
+	unsigned j = 0;
+	if (width == 1) {
+		const __m256d total = _mm256_set1_pd(sum[0]);
+		for (; j + 4 <= n; j += 4)
+			_mm256_storeu_pd(out + j, _mm256_mul_pd(_mm256_fmsub_pd(total, _mm256_loadu_pd(beta + j), _mm256_loadu_pd(b + j)), s));
+	} else if (width == 2) {
+		const __m256d total = _mm256_broadcast_pd(reinterpret_cast<__m128d const *>(sum));
+		for (; j + 2 <= n; j += 2)
+			_mm256_storeu_pd(out + 2 * j, _mm256_mul_pd(_mm256_fmsub_pd(total, pairs_avx2(beta + j), _mm256_loadu_pd(b + 2 * j)), s));
+	} else if (width % 4 == 0) {
+		for (; j < n; ++j) {
+			const __m256d weight = _mm256_set1_pd(beta[j]);
+			for (unsigned w = 0; w < width; w += 4)
+				_mm256_storeu_pd(out + j * width + w, _mm256_mul_pd(_mm256_fmsub_pd(_mm256_loadu_pd(sum + w), weight, _mm256_loadu_pd(b + j * width + w)), s));
+		}
+		return;
+	} else
+		return reflect_scalar(b, beta, sum, sign, n, width, out);
+	reflect_scalar(b + j * width, beta + j, sum, sign, n - j, width, out + j * width);
+}
+
+__attribute__((target("avx2,fma"))) void transpose_product_avx2 (double const *matrix, unsigned stride, double const *b, unsigned n, unsigned width, double *out)
+{
+	unsigned j = 0;
+	if (width == 1) {
+		for (; j + 4 <= n; j += 4) {
+			__m256d acc = _mm256_setzero_pd();
+			for (unsigned i = 0; i < n; ++i)
+				acc = _mm256_fmadd_pd(_mm256_loadu_pd(matrix + i * stride + j), _mm256_set1_pd(b[i]), acc);
+			_mm256_storeu_pd(out + j, acc);
+		}
+	} else if (width == 2) {
+		for (; j + 2 <= n; j += 2) {
+			__m256d acc = _mm256_setzero_pd();
+			for (unsigned i = 0; i < n; ++i)
+				acc = _mm256_fmadd_pd(pairs_avx2(matrix + i * stride + j), _mm256_broadcast_pd(reinterpret_cast<__m128d const *>(b + 2 * i)), acc);
+			_mm256_storeu_pd(out + 2 * j, acc);
+		}
+	} else if (width % 4 == 0) {
+		for (; j < n; ++j)
+			for (unsigned w = 0; w < width; w += 4) {
+				__m256d acc = _mm256_setzero_pd();
+				for (unsigned i = 0; i < n; ++i)
+					acc = _mm256_fmadd_pd(_mm256_set1_pd(matrix[i * stride + j]), _mm256_loadu_pd(b + i * width + w), acc);
+				_mm256_storeu_pd(out + j * width + w, acc);
+			}
+		return;
+	} else
+		return transpose_product_scalar(matrix, stride, b, n, width, out);
+	// remaining columns:
+	for (; j < n; ++j)
+		for (unsigned w = 0; w < width; ++w) {
+			double acc = 0;
+			for (unsigned i = 0; i < n; ++i)
+				acc += matrix[i * stride + j] * b[i * width + w];
+			out[j * width + w] = acc;
+		}
+}
+
+// AVX-512 kernels: twice as wide as the AVX2 ones,
+// which they defer to for the widths they do not cover.
+
+__attribute__((target("avx512f"))) inline __m512d pairs_avx512 (double const *x)
+{
+	// {x[0], x[0], x[1], x[1], x[2], x[2], x[3], x[3]}:
+	return _mm512_permutexvar_pd(_mm512_set_epi64(3, 3, 2, 2, 1, 1, 0, 0), _mm512_insertf64x4(_mm512_setzero_pd(), _mm256_loadu_pd(x), 0));
+}
+
+__attribute__((target("avx512f"))) inline __m512d repeat_avx512 (double const *x)
+{
+	// {x[0], x[1], x[0], x[1], x[0], x[1], x[0], x[1]}:
+	return _mm512_castps_pd(_mm512_broadcast_f32x4(_mm_castpd_ps(_mm_loadu_pd(x))));
+}
+
+__attribute__((target("avx512f"))) void weighted_sum_avx512 (double const *b, double const *beta, unsigned n, unsigned width, double *sum)
+{
+	double lane[8];
+	unsigned j = 0;
+	if (width == 1) {
+		__m512d acc = _mm512_setzero_pd();
+		for (; j + 8 <= n; j += 8)
+			acc = _mm512_fmadd_pd(_mm512_loadu_pd(b + j), _mm512_loadu_pd(beta + j), acc);
+		_mm512_storeu_pd(lane, acc);
+		sum[0] = ((lane[0] + lane[1]) + (lane[2] + lane[3])) + ((lane[4] + lane[5]) + (lane[6] + lane[7]));
+	} else if (width == 2) {
+		__m512d acc = _mm512_setzero_pd();
+		for (; j + 4 <= n; j += 4)
+			acc = _mm512_fmadd_pd(_mm512_loadu_pd(b + 2 * j), pairs_avx512(beta + j), acc);
+		_mm512_storeu_pd(lane, acc);
+		sum[0] = (lane[0] + lane[2]) + (lane[4] + lane[6]);
+		sum[1] = (lane[1] + lane[3]) + (lane[5] + lane[7]);
+	} else if (width % 8 == 0) {
+		for (unsigned w = 0; w < width; w += 8) {
+			__m512d acc = _mm512_setzero_pd();
+			for (unsigned i = 0; i < n; ++i)
+				acc = _mm512_fmadd_pd(_mm512_loadu_pd(b + i * width + w), _mm512_set1_pd(beta[i]), acc);
+			_mm512_storeu_pd(sum + w, acc);
+		}
+		return;
+	} else
+		return weighted_sum_avx2(b, beta, n, width, sum);
+	for (; j < n; ++j)
+		for (unsigned w = 0; w < width; ++w)
+			sum[w] += b[j * width + w] * beta[j];
+}
+
+__attribute__((target("avx512f"))) void reflect_avx512 (double const *b, double const *beta, double const *sum, double sign, unsigned n, unsigned width, double *out)
+{
+	const __m512d s = _mm512_set1_pd(sign);
+	unsigned j = 0;
+	if (width == 1) {
+		const __m512d total = _mm512_set1_pd(sum[0]);
+		for (; j + 8 <= n; j += 8)
+			_mm512_storeu_pd(out + j, _mm512_mul_pd(_mm512_fmsub_pd(total, _mm512_loadu_pd(beta + j), _mm512_loadu_pd(b + j)), s));
+	} else if (width == 2) {
+		const __m512d total = repeat_avx512(sum);
+		for (; j + 4 <= n; j += 4)
+			_mm512_storeu_pd(out + 2 * j, _mm512_mul_pd(_mm512_fmsub_pd(total, pairs_avx512(beta + j), _mm512_loadu_pd(b + 2 * j)), s));
+	} else if (width % 8 == 0) {
+		for (; j < n; ++j) {
+			const __m512d weight = _mm512_set1_pd(beta[j]);
+			for (unsigned w = 0; w < width; w += 8)
+				_mm512_storeu_pd(out + j * width + w, _mm512_mul_pd(_mm512_fmsub_pd(_mm512_loadu_pd(sum + w), weight, _mm512_loadu_pd(b + j * width + w)), s));
+		}
+		return;
+	} else
+		return reflect_avx2(b, beta, sum, sign, n, width, out);
+	reflect_scalar(b + j * width, beta + j, sum, sign, n - j, width, out + j * width);
+}
+
+__attribute__((target("avx512f"))) void transpose_product_avx512 (double const *matrix, unsigned stride, double const *b, unsigned n, unsigned width, double *out)
+{
+	unsigned j = 0;
+	if (width == 1) {
+		for (; j + 8 <= n; j += 8) {
+			__m512d acc = _mm512_setzero_pd();
+			for (unsigned i = 0; i < n; ++i)
+				acc = _mm512_fmadd_pd(_mm512_loadu_pd(matrix + i * stride + j), _mm512_set1_pd(b[i]), acc);
+			_mm512_storeu_pd(out + j, acc);
+		}
+	} else if (width == 2) {
+		for (; j + 4 <= n; j += 4) {
+			__m512d acc = _mm512_setzero_pd();
+			for (unsigned i = 0; i < n; ++i)
+				acc = _mm512_fmadd_pd(pairs_avx512(matrix + i * stride + j), repeat_avx512(b + 2 * i), acc);
+			_mm512_storeu_pd(out + 2 * j, acc);
+		}
+	} else if (width % 8 == 0) {
+		for (; j < n; ++j)
+			for (unsigned w = 0; w < width; w += 8) {
+				__m512d acc = _mm512_setzero_pd();
+				for (unsigned i = 0; i < n; ++i)
+					acc = _mm512_fmadd_pd(_mm512_set1_pd(matrix[i * stride + j]), _mm512_loadu_pd(b + i * width + w), acc);
+				_mm512_storeu_pd(out + j * width + w, acc);
+			}
+		return;
+	} else
+		return transpose_product_avx2(matrix, stride, b, n, width, out);
+	// remaining columns:
+	for (; j < n; ++j)
+		for (unsigned w = 0; w < width; ++w) {
+			double acc = 0;
+			for (unsigned i = 0; i < n; ++i)
+				acc += matrix[i * stride + j] * b[i * width + w];
+			out[j * width + w] = acc;
+		}
+}
+
+// Single precision kernels: real waves eight (AVX2) or sixteen (AVX-512) ports at a time,
+// wider waves as many floats at a time; the double scattering coefficients are rounded
+// to single precision as they are loaded. Any other width falls back to the scalar code.
+
+__attribute__((target("avx2,fma"))) inline __m256 rounded_avx2 (double const *x)
+{
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(_mm256_loadu_pd(x))), _mm256_cvtpd_ps(_mm256_loadu_pd(x + 4)), 1);
+}
+
+__attribute__((target("avx2,fma"))) void weighted_sum_avx2 (float const *b, float const *beta, unsigned n, unsigned width, float *sum)
+{
+	if (width == 1) {
+		float lane[8];
+		unsigned j = 0;
+		__m256 acc = _mm256_setzero_ps();
+		for (; j + 8 <= n; j += 8)
+			acc = _mm256_fmadd_ps(_mm256_loadu_ps(b + j), _mm256_loadu_ps(beta + j), acc);
+		_mm256_storeu_ps(lane, acc);
+		sum[0] = ((lane[0] + lane[1]) + (lane[2] + lane[3])) + ((lane[4] + lane[5]) + (lane[6] + lane[7]));
+		for (; j < n; ++j)
+			sum[0] += b[j] * beta[j];
+	} else if (width % 8 == 0) {
+		for (unsigned w = 0; w < width; w += 8) {
+			__m256 acc = _mm256_setzero_ps();
+			for (unsigned i = 0; i < n; ++i)
+				acc = _mm256_fmadd_ps(_mm256_loadu_ps(b + i * width + w), _mm256_set1_ps(beta[i]), acc);
+			_mm256_storeu_ps(sum + w, acc);
+		}
+	} else
+		weighted_sum_scalar(b, beta, n, width, sum);
+}
+
+__attribute__((target("avx2,fma"))) void reflect_avx2 (float const *b, float const *beta, float const *sum, float sign, unsigned n, unsigned width, float *out)
+{
+	const __m256 s = _mm256_set1_ps(sign);
+	if (width == 1) {
+		const __m256 total = _mm256_set1_ps(sum[0]);
+		unsigned j = 0;
+		for (; j + 8 <= n; j += 8)
+			_mm256_storeu_ps(out + j, _mm256_mul_ps(_mm256_fmsub_ps(total, _mm256_loadu_ps(beta + j), _mm256_loadu_ps(b + j)), s));
+		reflect_scalar(b + j, beta + j, sum, sign, n - j, width, out + j);
+	} else if (width % 8 == 0) {
+		for (unsigned j = 0; j < n; ++j) {
+			const __m256 weight = _mm256_set1_ps(beta[j]);
+			for (unsigned w = 0; w < width; w += 8)
+				_mm256_storeu_ps(out + j * width + w, _mm256_mul_ps(_mm256_fmsub_ps(_mm256_loadu_ps(sum + w), weight, _mm256_loadu_ps(b + j * width + w)), s));
+		}
+	} else
+		reflect_scalar(b, beta, sum, sign, n, width, out);
+}
+
+__attribute__((target("avx2,fma"))) void transpose_product_avx2 (double const *matrix, unsigned stride, float const *b, unsigned n, unsigned width, float *out)
+{
+	if (width == 1) {
+		unsigned j = 0;
+		for (; j + 8 <= n; j += 8) {
+			__m256 acc = _mm256_setzero_ps();
+			for (unsigned i = 0; i < n; ++i)
+				acc = _mm256_fmadd_ps(rounded_avx2(matrix + i * stride + j), _mm256_set1_ps(b[i]), acc);
+			_mm256_storeu_ps(out + j, acc);
+		}
+		for (; j < n; ++j) {
+			float acc = 0;
+			for (unsigned i = 0; i < n; ++i)
+				acc += float(matrix[i * stride + j]) * b[i];
+			out[j] = acc;
+		}
+	} else if (width % 8 == 0) {
+		for (unsigned j = 0; j < n; ++j)
+			for (unsigned w = 0; w < width; w += 8) {
+				__m256 acc = _mm256_setzero_ps();
+				for (unsigned i = 0; i < n; ++i)
+					acc = _mm256_fmadd_ps(_mm256_set1_ps(float(matrix[i * stride + j])), _mm256_loadu_ps(b + i * width + w), acc);
+				_mm256_storeu_ps(out + j * width + w, acc);
+			}
+	} else
+		transpose_product_scalar(matrix, stride, b, n, width, out);
+}
+
+__attribute__((target("avx512f"))) inline __m512 rounded_avx512 (double const *x)
+{
+	const __m256 low = _mm512_cvtpd_ps(_mm512_loadu_pd(x)), high = _mm512_cvtpd_ps(_mm512_loadu_pd(x + 8));
+	return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_insertf64x4(_mm512_setzero_pd(), _mm256_castps_pd(low), 0), _mm256_castps_pd(high), 1));
+}
+
+__attribute__((target("avx512f"))) void weighted_sum_avx512 (float const *b, float const *beta, unsigned n, unsigned width, float *sum)
+{
+	if (width == 1) {
+		float lane[16];
+		unsigned j = 0;
+		__m512 acc = _mm512_setzero_ps();
+		for (; j + 16 <= n; j += 16)
+			acc = _mm512_fmadd_ps(_mm512_loadu_ps(b + j), _mm512_loadu_ps(beta + j), acc);
+		_mm512_storeu_ps(lane, acc);
+		for (unsigned half = 8; half; half /= 2)
+			for (unsigned k = 0; k < half; ++k)
+				lane[k] = lane[2 * k] + lane[2 * k + 1];
+		sum[0] = lane[0];
+		for (; j < n; ++j)
+			sum[0] += b[j] * beta[j];
+	} else if (width % 16 == 0) {
+		for (unsigned w = 0; w < width; w += 16) {
+			__m512 acc = _mm512_setzero_ps();
+			for (unsigned i = 0; i < n; ++i)
+				acc = _mm512_fmadd_ps(_mm512_loadu_ps(b + i * width + w), _mm512_set1_ps(beta[i]), acc);
+			_mm512_storeu_ps(sum + w, acc);
+		}
+	} else
+		weighted_sum_avx2(b, beta, n, width, sum);
+}
+
+__attribute__((target("avx512f"))) void reflect_avx512 (float const *b, float const *beta, float const *sum, float sign, unsigned n, unsigned width, float *out)
+{
+	const __m512 s = _mm512_set1_ps(sign);
+	if (width == 1) {
+		const __m512 total = _mm512_set1_ps(sum[0]);
+		unsigned j = 0;
+		for (; j + 16 <= n; j += 16)
+			_mm512_storeu_ps(out + j, _mm512_mul_ps(_mm512_fmsub_ps(total, _mm512_loadu_ps(beta + j), _mm512_loadu_ps(b + j)), s));
+		reflect_scalar(b + j, beta + j, sum, sign, n - j, width, out + j);
+	} else if (width % 16 == 0) {
+		for (unsigned j = 0; j < n; ++j) {
+			const __m512 weight = _mm512_set1_ps(beta[j]);
+			for (unsigned w = 0; w < width; w += 16)
+				_mm512_storeu_ps(out + j * width + w, _mm512_mul_ps(_mm512_fmsub_ps(_mm512_loadu_ps(sum + w), weight, _mm512_loadu_ps(b + j * width + w)), s));
+		}
+	} else
+		reflect_avx2(b, beta, sum, sign, n, width, out);
+}
+
+__attribute__((target("avx512f"))) void transpose_product_avx512 (double const *matrix, unsigned stride, float const *b, unsigned n, unsigned width, float *out)
+{
+	if (width == 1) {
+		unsigned j = 0;
+		for (; j + 16 <= n; j += 16) {
+			__m512 acc = _mm512_setzero_ps();
+			for (unsigned i = 0; i < n; ++i)
+				acc = _mm512_fmadd_ps(rounded_avx512(matrix + i * stride + j), _mm512_set1_ps(b[i]), acc);
+			_mm512_storeu_ps(out + j, acc);
+		}
+		for (; j < n; ++j) {
+			float acc = 0;
+			for (unsigned i = 0; i < n; ++i)
+				acc += float(matrix[i * stride + j]) * b[i];
+			out[j] = acc;
+		}
+	} else if (width % 16 == 0) {
+		for (unsigned j = 0; j < n; ++j)
+			for (unsigned w = 0; w < width; w += 16) {
+				__m512 acc = _mm512_setzero_ps();
+				for (unsigned i = 0; i < n; ++i)
+					acc = _mm512_fmadd_ps(_mm512_set1_ps(float(matrix[i * stride + j])), _mm512_loadu_ps(b + i * width + w), acc);
+				_mm512_storeu_ps(out + j * width + w, acc);
+			}
+	} else
+		transpose_product_avx2(matrix, stride, b, n, width, out);
+}
+
+#endif // WAVE_KERNELS_X86
+
+int best_level ()
+{
+#ifdef WAVE_KERNELS_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) return 2;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return 1;
+#endif
+	return 0;
+}
+
+} // anonymous namespace
+
+template <class S> wave_kernels<S> &wave_kernels<S>::current ()
+{
+	static wave_kernels kernels = {weighted_sum_scalar, reflect_scalar, transpose_product_scalar};
+	static bool chosen = false;
+	if (!chosen) {
+		chosen = true;
+		select(avx512);
+	}
+	return kernels;
+}
+
+template <class S> typename wave_kernels<S>::level wave_kernels<S>::select (level requested)
+{
+	wave_kernels &kernels = current();
+	level chosen = std::min(requested, level(best_level()));
+	switch (chosen) {
+#ifdef WAVE_KERNELS_X86
+	case avx512:
+		kernels.weighted_sum = weighted_sum_avx512;
+		kernels.reflect = reflect_avx512;
+		kernels.transpose_product = transpose_product_avx512;
+		break;
+	case avx2:
+		kernels.weighted_sum = weighted_sum_avx2;
+		kernels.reflect = reflect_avx2;
+		kernels.transpose_product = transpose_product_avx2;
+		break;
+#endif
+	default:
+		chosen = scalar;
+		kernels.weighted_sum = weighted_sum_scalar;
+		kernels.reflect = reflect_scalar;
+		kernels.transpose_product = transpose_product_scalar;
+	}
+	return chosen;
+}
+
+template struct wave_kernels <double>;
+template struct wave_kernels <float>;
+
 // Implementation of class scatter_junction:
 
-scatter_junction::scatter_junction ()
+scatter_junction::scatter_junction () : kirchhoff(0), order(0), across(0)
 {
 	for (int i = 0; i < max_dim; ++i)
 		for (int j = 0; j < max_dim; ++j)
 			scatter[i][j] = 0;
 }
 
+#ifndef HAVE_LAPACK
+namespace {
+
+// Cache-blocked LU decomposition with partial pivoting of the n x n row-major matrix a
+// (right-looking: each panel of nb columns is factored, then the trailing submatrix
+// is updated with row-contiguous, vectorizable loops); returns 0 or 1 + singular column.
+int blocked_lu (double *a, int n, int *pivot)
+{
+	const int nb = 16;
+	for (int k0 = 0; k0 < n; k0 += nb) {
+		const int k1 = std::min(k0 + nb, n);
+		// panel factorization:
+		for (int k = k0; k < k1; ++k) {
+			int p = k;
+			for (int i = k + 1; i < n; ++i)
+				if (std::abs(a[i * n + k]) > std::abs(a[p * n + k])) p = i;
+			if (a[p * n + k] == 0) return k + 1;
+			pivot[k] = p;
+			if (p != k) std::swap_ranges(a + k * n, a + (k + 1) * n, a + p * n);
+			const double d = 1 / a[k * n + k];
+			for (int i = k + 1; i < n; ++i) {
+				const double l = a[i * n + k] *= d;
+				for (int j = k + 1; j < k1; ++j)
+					a[i * n + j] -= l * a[k * n + j];
+			}
+		}
+		// block row of U:
+		for (int k = k0; k < k1; ++k)
+			for (int i = k + 1; i < k1; ++i) {
+				const double l = a[i * n + k];
+				for (int j = k1; j < n; ++j)
+					a[i * n + j] -= l * a[k * n + j];
+			}
+		// trailing update:
+		for (int i = k1; i < n; ++i)
+			for (int k = k0; k < k1; ++k) {
+				const double l = a[i * n + k];
+				if (l == 0) continue;
+				const double *u = a + k * n;
+				double *row = a + i * n;
+				for (int j = k1; j < n; ++j)
+					row[j] -= l * u[j];
+			}
+	}
+	return 0;
+}
+
+// Overwrites the row-major right-hand sides b (n x n) with the solution of (LU) x = P b.
+void lu_solve (double const *lu, int n, int const *pivot, double *b)
+{
+	for (int k = 0; k < n; ++k)
+		if (pivot[k] != k) std::swap_ranges(b + k * n, b + (k + 1) * n, b + pivot[k] * n);
+	for (int i = 1; i < n; ++i)
+		for (int k = 0; k < i; ++k) {
+			const double l = lu[i * n + k];
+			if (l != 0)
+				for (int j = 0; j < n; ++j)
+					b[i * n + j] -= l * b[k * n + j];
+		}
+	for (int i = n - 1; i >= 0; --i) {
+		for (int k = i + 1; k < n; ++k) {
+			const double u = lu[i * n + k];
+			if (u != 0)
+				for (int j = 0; j < n; ++j)
+					b[i * n + j] -= u * b[k * n + j];
+		}
+		const double d = 1 / lu[i * n + i];
+		for (int j = 0; j < n; ++j)
+			b[i * n + j] *= d;
+	}
+}
+
+}
+#endif
+
+void scatter_junction::system_column (unsigned port, double norm, double *column) const
+{
+	for (int j = 0; j < order; ++j)
+		column[j] = j < across ? kirchhoff[j * order + port] * norm : kirchhoff[j * order + port] / norm;
+}
+
 int scatter_junction::compute_scattering (double const *norms)
 {
 	int na = 0, nt = 0;
-	const short *matrix = incidence_matrix(na, nt);
-	double system[max_dim][max_dim];
-	int n = na + nt;
-	for (unsigned i = 0; i < n; ++i) {
-		for (unsigned j = 0; j < na; ++j)
-			scatter[i][j] = -(system[i][j] = matrix[j * n + i] * norms[i]);
-		for (unsigned j = na; j < n; ++j)
-			scatter[i][j] = +(system[i][j] = matrix[j * n + i] / norms[i]);
+	kirchhoff = incidence_matrix(na, nt);
+	const int n = order = na + nt;
+	across = na;
+	// The system matrix A has a row for each equation and a column for each port,
+	// the scattering matrix is X = inverse(A) J A, where J = diag(-1 for across, +1 for through):
+	system.resize(n * n);
+	inverse.assign(n * n, 0);
+	std::vector <double> column(n);
+	for (int i = 0; i < n; ++i) {
+		system_column(i, norms[i], &column[0]);
+		for (int j = 0; j < n; ++j)
+			system[j * n + i] = column[j];
+		inverse[i * n + i] = 1;
 	}
+	std::vector <double> lu(system);
+	std::vector <int> pivot(n);
 	int info = 0;
 #ifdef HAVE_LAPACK
-	int pivot[max_dim];
-	dgesv_(n, n, &system[0][0], max_dim, &pivot[0], &scatter[0][0], max_dim, info);
+	// row-major matrices look transposed to LAPACK, and so does the inverse:
+	dgesv_(n, n, &lu[0], n, &pivot[0], &inverse[0], n, info);
 #else
-	for (unsigned k = 0; k < n - 1; ++k) {
-		double max = 0;
-		int p = k;
-		for (unsigned i = k; i < n; ++i)
-			if (std::abs(system[k][i]) > max) {
-				max = std::abs(system[k][i]);
-				p = i;
+	if (!(info = blocked_lu(&lu[0], n, &pivot[0])))
+		lu_solve(&lu[0], n, &pivot[0], &inverse[0]);
+#endif
+	if (info < 0) {
+		std::cerr << "Error in scatter junction: invalid argument " << -info << std::endl;
+	} else if (info > 0) {
+		std::cerr << "Error in scatter junction: singularity detected!" << std::endl;
+	} else {
+		for (int j = 0; j < n; ++j) {
+			double *x = &column[0];
+			for (int i = 0; i < n; x[i++] = 0);
+			for (int k = 0; k < n; ++k) {
+				const double c = k < na ? -inverse[j * n + k] : inverse[j * n + k];
+				const double *a = &system[k * n];
+				for (int i = 0; i < n; ++i)
+					x[i] += c * a[i];
 			}
-		if (max == 0) { // singular matrix
-			info = k + 1;
-			break;
-		}
-		for (unsigned i = 0; i < n; ++i) {
-			std::swap(system[i][k], system[i][p]);
-			std::swap(scatter[i][k], scatter[i][p]);
-		}
-		for (unsigned i = k + 1; i < n; ++i) {
-			system[k][i] /= system[k][k];
-			for (unsigned j = k + 1; j < n; ++j)
-				system[j][i] -= system[k][i] * system[j][k];
+			for (int i = 0; i < n; ++i)
+				scatter[i][j] = x[i];
 		}
+		return n;
+	}
+	inverse.clear();
+	return 0;
+}
+
+int scatter_junction::rescatter (unsigned port, double norm)
+{
+	const int n = order;
+	if (inverse.empty() || int(port) >= n) return 0;
+	// rank-1 change of the system matrix: A' = A + u e_port^T
+	std::vector <double> u(n), w(n, 0), row(n), v(n, 0);
+	system_column(port, norm, &u[0]);
+	for (int j = 0; j < n; ++j)
+		u[j] -= system[j * n + port];
+	for (int j = 0; j < n; ++j)
+		for (int k = 0; k < n; ++k)
+			w[j] += inverse[j * n + k] * u[k];
+	const double den = 1 + w[port];
+	if (std::abs(den) < 1e-12) return 0;
+	// Sherman-Morrison on the scattering matrix first, X' = X - w X(port,:) / den + inverse(A') J u e_port^T:
+	for (int i = 0; i < n; ++i)
+		row[i] = scatter[i][port] / den;
+	for (int i = 0; i < n; ++i)
+		for (int j = 0; j < n; ++j)
+			scatter[i][j] -= w[j] * row[i];
+	// then on the inverse itself:
+	for (int k = 0; k < n; ++k)
+		row[k] = inverse[port * n + k] / den;
+	for (int j = 0; j < n; ++j)
+		for (int k = 0; k < n; ++k)
+			inverse[j * n + k] -= w[j] * row[k];
+	for (int j = 0; j < n; ++j)
+		for (int k = 0; k < n; ++k)
+			v[j] += inverse[j * n + k] * (k < across ? -u[k] : u[k]);
+	for (int j = 0; j < n; ++j) {
+		scatter[port][j] += v[j];
+		system[j * n + port] += u[j];
+	}
+	return n;
+}
+
+// Implementation of class netlist_junction:
+
+unsigned netlist_junction::add_branch (unsigned from, unsigned to)
+{
+	ends.push_back(std::make_pair(from, to));
+	return ends.size() - 1;
+}
+
+const short *netlist_junction::incidence_matrix (int &across, int &through) const
+{
+	const unsigned n = ends.size();
+	// compact node numbering:
+	std::map <unsigned, unsigned> index;
+	for (unsigned k = 0; k < n; ++k) {
+		index.insert(std::make_pair(ends[k].first,  0));
+		index.insert(std::make_pair(ends[k].second, 0));
+	}
+	unsigned nodes = 0;
+	for (std::map <unsigned, unsigned>::iterator i = index.begin(); i != index.end(); ++i)
+		i->second = nodes++;
+	std::vector <unsigned> from(n), to(n);
+	std::vector <std::vector <unsigned> > incident(nodes);
+	for (unsigned k = 0; k < n; ++k) {
+		incident[from[k] = index[ends[k].first]].push_back(k);
+		incident[to[k] = index[ends[k].second]].push_back(k);
 	}
-	if (!info) {
-		for (unsigned k = 0; k < n; ++k) {
-			for (unsigned i = 0; i < n; ++i) {
-				for (unsigned j = 0; j < i; ++j)
-					scatter[k][i] -= system[j][i] * scatter[k][j];
+	// spanning forest (breadth first), each node remembering the tree branch to its parent:
+	const unsigned none = ~0u;
+	std::vector <unsigned> up(nodes, none), depth(nodes, 0);
+	std::vector <bool> visited(nodes, false), tree(n, false);
+	std::vector <unsigned> roots, queue;
+	for (unsigned r = 0; r < nodes; ++r) {
+		if (visited[r]) continue;
+		visited[r] = true;
+		roots.push_back(r);
+		queue.assign(1, r);
+		for (unsigned q = 0; q < queue.size(); ++q) {
+			const unsigned node = queue[q];
+			for (unsigned e = 0; e < incident[node].size(); ++e) {
+				const unsigned k = incident[node][e];
+				const unsigned other = from[k] == node ? to[k] : from[k];
+				if (visited[other]) continue;
+				visited[other] = tree[k] = true;
+				up[other] = k;
+				depth[other] = depth[node] + 1;
+				queue.push_back(other);
 			}
-			for (unsigned i = n - 1; i < n; --i) {
-				for (unsigned j = i + 1; j < n; ++j)
-					scatter[k][i] -= system[j][i] * scatter[k][j];
-				scatter[k][i] /= system[i][i];
+		}
+	}
+	matrix.assign(n * n, 0);
+	int row = 0;
+	// voltage laws, one for each chord: v(chord) plus the tree path from its end back to its start:
+	for (unsigned k = 0; k < n; ++k) {
+		if (tree[k]) continue;
+		short *law = &matrix[row++ * n];
+		law[k] = +1;
+		unsigned a = to[k], b = from[k];
+		while (a != b) {
+			if (depth[a] >= depth[b]) {
+				// walking up from a: the tree branch is traversed from a to its parent
+				const unsigned j = up[a];
+				law[j] += from[j] == a ? +1 : -1;
+				a = from[j] == a ? to[j] : from[j];
+			} else {
+				// walking up from b: the branch will be traversed from the parent down to b
+				const unsigned j = up[b];
+				law[j] += to[j] == b ? +1 : -1;
+				b = from[j] == b ? to[j] : from[j];
 			}
 		}
 	}
-#endif
-	if (info < 0) {
-		std::cerr << "Error in scatter junction: invalid argument " << -info << std::endl;
-	} else if (info > 0) {
-		std::cerr << "Error in scatter junction: singularity detected!" << std::endl;
-	} else return n;
-	return 0;
+	across = row;
+	// current laws, for every node but the root of each tree:
+	for (unsigned node = 0; node < nodes; ++node) {
+		if (up[node] == none) continue;
+		short *law = &matrix[row++ * n];
+		for (unsigned e = 0; e < incident[node].size(); ++e) {
+			const unsigned k = incident[node][e];
+			if (from[k] == to[k]) continue;
+			law[k] += from[k] == node ? +1 : -1;
+		}
+	}
+	through = row - across;
+	return &matrix[0];
 }
 